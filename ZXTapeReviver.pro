@@ -11,7 +11,7 @@
 # permission of the Author.
 #*******************************************************************************
 
-QT += quick gui quickcontrols2 multimedia
+QT += quick gui quickcontrols2 multimedia concurrent
 
 # The following define makes your compiler emit warnings if you use
 # any Qt feature that has been marked deprecated (the exact warnings
@@ -80,15 +80,26 @@ DEFINES += TRANSLATION_IDS_HEADER="\\\"$${TRANSLATIONS_GENERATED_FILENAME_H}\\\"
 SOURCES += \
         sources/actions/actionbase.cpp \
         sources/actions/editsampleaction.cpp \
+        sources/actions/flipbitsaction.cpp \
         sources/actions/shiftwaveformaction.cpp \
+        sources/batch/batchprocessor.cpp \
         sources/core/parseddata.cpp \
         sources/main.cpp \
         sources/models/actionsmodel.cpp \
         sources/models/dataplayermodel.cpp \
         sources/models/fileworkermodel.cpp \
         sources/controls/waveformcontrol.cpp \
+        sources/core/bitrepairsolver.cpp \
+        sources/core/halfwaveclassifier.cpp \
+        sources/core/halfwaveparser.cpp \
+        sources/core/halfwavestore.cpp \
+        sources/core/parsersettingstuner.cpp \
+        sources/core/sampledecoder.cpp \
+        sources/core/waveformcodec.cpp \
         sources/core/waveformparser.cpp \
         sources/core/wavreader.cpp \
+        sources/core/zerocrossingdetector.cpp \
+        sources/models/parsedblocksmodel.cpp \
         sources/models/parsersettingsmodel.cpp \
         sources/models/suspiciouspointsmodel.cpp \
         sources/models/waveformmodel.cpp \
@@ -100,15 +111,28 @@ SOURCES += \
 HEADERS += \
     sources/actions/actionbase.h \
     sources/actions/editsampleaction.h \
+    sources/actions/flipbitsaction.h \
     sources/actions/shiftwaveformaction.h \
+    sources/batch/batchprocessor.h \
+    sources/core/bitrepairsolver.h \
+    sources/core/halfwaveclassifier.h \
+    sources/core/halfwaveparser.h \
+    sources/core/halfwavescanner.h \
+    sources/core/halfwavestore.h \
     sources/core/parseddata.h \
+    sources/core/parsersettingstuner.h \
     sources/defines.h \
     sources/models/actionsmodel.h \
     sources/models/dataplayermodel.h \
     sources/models/fileworkermodel.h \
     sources/controls/waveformcontrol.h \
+    sources/core/sampledecoder.h \
+    sources/core/waveformcodec.h \
     sources/core/waveformparser.h \
     sources/core/wavreader.h \
+    sources/core/wavvector.h \
+    sources/core/zerocrossingdetector.h \
+    sources/models/parsedblocksmodel.h \
     sources/models/parsersettingsmodel.h \
     sources/models/suspiciouspointsmodel.h \
     sources/models/waveformmodel.h \
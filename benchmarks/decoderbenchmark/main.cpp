@@ -0,0 +1,99 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "sources/core/sampledecoder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace {
+    struct Format {
+        const char* name;
+        uint16_t compressionCode;
+        uint16_t bitsPerSample;
+    };
+
+    //Runs the decoder over the synthetic buffer in windows of the streaming size and returns the best throughput in samples per second
+    template <typename T>
+    double measure(SampleDecoder::DecodeFunction<T> decode, const std::vector<uint8_t>& src, size_t frames, size_t frameSize, uint16_t numberOfChannels) {
+        constexpr const size_t windowFrames = 1024 * 1024;
+        std::vector<T> ch0(frames);
+        std::vector<T> ch1(frames);
+        double best = 1e30;
+        for (int r = 0; r < 7; ++r) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t f = 0; f < frames; f += windowFrames) {
+                const size_t n = std::min(windowFrames, frames - f);
+                decode(src.data() + f * frameSize, n, ch0.data() + f, ch1.data() + f);
+            }
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return frames * numberOfChannels / best;
+    }
+
+    template <typename T>
+    void run(const Format& format, uint16_t numberOfChannels, size_t frames) {
+        const auto decode = SampleDecoder::getDecodeFunction<T>(format.compressionCode, format.bitsPerSample, numberOfChannels);
+        if (!decode) {
+            printf("%-8s %-6s: not supported\n", format.name, numberOfChannels == 1 ? "mono" : "stereo");
+            return;
+        }
+
+        const size_t frameSize = format.bitsPerSample / 8 * numberOfChannels;
+        std::vector<uint8_t> src(frames * frameSize);
+        std::mt19937 gen(1);
+        std::generate(src.begin(), src.end(), [&gen]() { return static_cast<uint8_t>(gen()); });
+        if (format.compressionCode == 3) {
+            //Random bytes make NaNs and denormals, so fill float samples with the values in the normal range
+            std::uniform_real_distribution<float> dist(-1.f, 1.f);
+            for (size_t i = 0; i < src.size(); i += sizeof(float)) {
+                const float v = dist(gen);
+                std::memcpy(src.data() + i, &v, sizeof(float));
+            }
+        }
+
+        printf("%-8s %-6s -> %-7s: %8.0f Msamples/s\n", format.name, numberOfChannels == 1 ? "mono" : "stereo",
+               std::is_integral_v<T> ? "int16" : "float", measure(decode, src, frames, frameSize, numberOfChannels) / 1e6);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    //Frames per run, the default is a bit more than 10 minutes at 44.1 kHz
+    const size_t frames = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 32 * 1024 * 1024;
+    const Format formats[] = {
+        { "PCM8",    1, 8 },
+        { "PCM16",   1, 16 },
+        { "PCM24",   1, 24 },
+        { "PCM32",   1, 32 },
+        { "Float32", 3, 32 }
+    };
+
+    printf("Decoding %zu frames\n", frames);
+    for (const auto& format: formats) {
+        for (uint16_t numberOfChannels: { 1, 2 }) {
+            //Same output types as WavReader uses: 8 and 16-bit samples are kept as int16, the rest are converted to float
+            if (format.compressionCode == 1 && format.bitsPerSample <= 16) {
+                run<int16_t>(format, numberOfChannels, frames);
+            }
+            run<float>(format, numberOfChannels, frames);
+        }
+    }
+
+    return 0;
+}
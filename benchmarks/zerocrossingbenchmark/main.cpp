@@ -0,0 +1,112 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "sources/core/zerocrossingdetector.h"
+#include "sources/defines.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+namespace {
+    //Same block size as HalfWaveScanner feeds to the detector
+    constexpr const size_t crossingsBlockSize = 4096;
+
+    //Synthetic tape at the given sample rate: pilot tone, synchro pulse and random data bits with a bit of noise
+    template <typename T>
+    std::vector<T> makeSignal(size_t size, double sampleRate, double amplitude) {
+        std::mt19937 gen(1);
+        std::normal_distribution<double> noise(0, amplitude * 0.02);
+        std::vector<T> signal;
+        signal.reserve(size);
+        auto append = [&](double freq, int halfWaves) {
+            const size_t length = static_cast<size_t>(sampleRate / freq / 2);
+            for (int h = 0; h < halfWaves && signal.size() < size; ++h) {
+                for (size_t i = 0; i < length && signal.size() < size; ++i) {
+                    const double v = std::sin(M_PI * (i + 0.5) / length) * (h & 1 ? -amplitude : amplitude);
+                    signal.push_back(static_cast<T>(v + noise(gen)));
+                }
+            }
+        };
+
+        while (signal.size() < size) {
+            append(SignalFrequencies::PILOT_FREQ, 8000);
+            append(SignalFrequencies::SYNCHRO_FREQ, 2);
+            for (int b = 0; b < 8 * 6912; ++b) {
+                append(gen() & 1 ? SignalFrequencies::ONE_FREQ : SignalFrequencies::ZERO_FREQ, 2);
+            }
+        }
+        return signal;
+    }
+
+    //Per-sample search of the sign changes the parser used before ZeroCrossingDetector
+    template <typename T>
+    size_t detectFindIf(const T* data, size_t size, bool negative, uint32_t* crossings) {
+        size_t count = 0;
+        const T* it = data;
+        const T* end = data + size;
+        while ((it = std::find_if(it, end, [negative](T v) { return lessThanZero(v) != negative; })) != end) {
+            crossings[count++] = static_cast<uint32_t>(it - data);
+            negative = !negative;
+        }
+        return count;
+    }
+
+    //Returns the best time of scanning the whole signal block by block
+    template <typename T>
+    double measure(const std::vector<T>& signal, ZeroCrossingDetector::DetectFunction<T> detect, size_t& crossingsCount) {
+        static uint32_t crossings[crossingsBlockSize];
+        double best = 1e30;
+        for (int r = 0; r < 7; ++r) {
+            crossingsCount = 0;
+            bool negative = lessThanZero(signal.front());
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t b = 0; b < signal.size(); b += crossingsBlockSize) {
+                const size_t n = std::min(crossingsBlockSize, signal.size() - b);
+                crossingsCount += detect(signal.data() + b, n, negative, crossings);
+                negative = lessThanZero(signal[b + n - 1]);
+            }
+            best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    template <typename T>
+    void run(const char* name, double amplitude, size_t size, size_t cachedSize) {
+        const auto signal = makeSignal<T>(size, 44100, amplitude);
+        const std::vector<T> cached(signal.begin(), signal.begin() + std::min(cachedSize, size));
+        for (const auto* data: { &cached, &signal }) {
+            size_t findIfCrossings, kernelCrossings;
+            const double findIfTime = measure(*data, &detectFindIf<T>, findIfCrossings);
+            const double kernelTime = measure(*data, ZeroCrossingDetector::getDetectFunction<T>(), kernelCrossings);
+            printf("%-5s %9zu samples: find_if %6.0f Msamples/s, detector %6.0f Msamples/s, %.2fx%s\n", name, data->size(),
+                   data->size() / findIfTime / 1e6, data->size() / kernelTime / 1e6, findIfTime / kernelTime,
+                   findIfCrossings == kernelCrossings ? "" : " (crossings mismatch)");
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    //Samples of the signal, the default is 10 minutes at 44.1 kHz. Its first 64K samples are measured separately as cache resident data
+    const size_t size = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 44100 * 600;
+    const size_t cachedSize = 64 * 1024;
+
+    run<int16_t>("int16", 20000, size, cachedSize);
+    run<float>("float", 20000, size, cachedSize);
+
+    return 0;
+}
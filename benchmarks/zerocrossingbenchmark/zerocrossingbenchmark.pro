@@ -0,0 +1,26 @@
+#*******************************************************************************
+# ZX Tape Reviver
+#-----------------
+#
+# Author: Leonid Golouz
+# E-mail: lgolouz@list.ru
+# YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+# YouTube channel e-mail: computerenthusiasttips@mail.ru
+#
+# Code modification and distribution of any kind is not allowed without direct
+# permission of the Author.
+#*******************************************************************************
+
+QT -= gui
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+        main.cpp \
+        ../../sources/core/zerocrossingdetector.cpp
+
+HEADERS += \
+    ../../sources/core/zerocrossingdetector.h \
+    ../../sources/defines.h
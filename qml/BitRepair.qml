@@ -0,0 +1,94 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+import QtQuick 2.3
+import QtQuick.Controls 1.3
+import QtQuick.Dialogs 1.3
+
+import com.models.zxtapereviver 1.0
+import com.core.zxtapereviver 1.0
+
+Dialog {
+    id: bitRepairDialog
+
+    property int channelNumber: 0
+    property int blockNumber: -1
+
+    signal bitsRepaired();
+
+    visible: false
+    title: Translations.id_bit_repair_window_header
+    standardButtons: StandardButton.Ok | StandardButton.Cancel
+    modality: Qt.WindowModal
+    width: 500
+    height: 300
+
+    Button {
+        id: searchButton
+
+        text: WaveformParser.searchingBitRepairs ? Translations.id_searching_bit_repairs : Translations.id_search_bit_repairs
+        enabled: blockNumber !== -1 && !WaveformParser.searchingBitRepairs
+        onClicked: {
+            WaveformParser.searchBitRepairs(channelNumber, blockNumber);
+        }
+    }
+
+    Text {
+        id: outdatedBlockText
+
+        anchors {
+            left: searchButton.right
+            verticalCenter: searchButton.verticalCenter
+            leftMargin: 5
+        }
+        visible: !WaveformParser.bitRepairsValid
+        color: "red"
+        text: Translations.id_bit_repair_block_outdated
+    }
+
+    TableView {
+        id: bitRepairsView
+
+        anchors {
+            top: searchButton.bottom
+            left: parent.left
+            right: parent.right
+            topMargin: 2
+        }
+        height: 220
+
+        selectionMode: SelectionMode.SingleSelection
+        model: WaveformParser.bitRepairs
+        itemDelegate: Text {
+            text: styleData.column === 0 ? modelData.flips : modelData.cost
+        }
+
+        TableViewColumn {
+            title: Translations.id_flipped_bits
+            width: bitRepairsView.width * 0.8
+        }
+
+        TableViewColumn {
+            title: Translations.id_bit_repair_cost
+            width: bitRepairsView.width * 0.2
+        }
+    }
+
+    onAccepted: {
+        if (bitRepairsView.currentRow !== -1) {
+            ActionsModel.repairBits(bitRepairsView.currentRow);
+            bitsRepaired();
+        }
+    }
+}
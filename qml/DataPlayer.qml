@@ -111,7 +111,7 @@ Dialog {
         model: parsedChannel
         itemDelegate: Text {
             text: styleData.value
-            color: modelData.state === 0 ? "black" : "red"
+            color: model.state === 0 ? "black" : "red"
         }
     }
 
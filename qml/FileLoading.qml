@@ -0,0 +1,44 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+import QtQuick 2.3
+import QtQuick.Controls 1.3
+import QtQuick.Dialogs 1.3
+
+import com.models.zxtapereviver 1.0
+import "."
+
+Dialog {
+    id: fileLoadingDialog
+
+    visible: false
+    title: Translations.id_loading_file_window_header
+    standardButtons: StandardButton.Cancel
+    modality: Qt.WindowModal
+    width: 400
+
+    ProgressBar {
+        anchors {
+            left: parent.left
+            right: parent.right
+        }
+
+        minimumValue: 0
+        maximumValue: 1
+        value: FileWorkerModel.loadingProgress
+    }
+
+    onRejected: {
+        FileWorkerModel.cancelLoading();
+    }
+}
@@ -17,6 +17,7 @@ import QtQuick.Dialogs 1.3
 import QtQuick.Layouts 1.15
 
 import com.models.zxtapereviver 1.0
+import com.core.zxtapereviver 1.0
 import "."
 
 Dialog {
@@ -28,6 +29,8 @@ Dialog {
     modality: Qt.WindowModal
     width: grid.width * 1.02
 
+    property int channelNumber: 0
+
     Grid {
         id: grid
         columns: 4
@@ -225,6 +228,7 @@ Dialog {
         visible: checkForAbnormalSineCheckbox.checked
     }
     TextField {
+        id: sineCheckToleranceTextField
         anchors.top: sineCheckToleranceText.bottom
         text: ParserSettingsModel.sineCheckTolerance;
         onTextChanged: {
@@ -233,6 +237,33 @@ Dialog {
         visible: checkForAbnormalSineCheckbox.checked
     }
 
+    Row {
+        anchors.top: sineCheckToleranceTextField.bottom
+        anchors.topMargin: 5
+        spacing: 5
+
+        Button {
+            text: WaveformParser.autoTuning ? Translations.id_auto_tuning_settings : Translations.id_auto_tune_settings
+            enabled: !WaveformParser.autoTuning
+            onClicked: {
+                autoTuneResultText.text = "";
+                WaveformParser.autoTuneSettings(channelNumber);
+            }
+        }
+
+        Text {
+            id: autoTuneResultText
+            anchors.verticalCenter: parent.verticalCenter
+        }
+    }
+
+    Connections {
+        target: WaveformParser
+        function onSettingsAutoTuned(okBlocks, blocks) {
+            autoTuneResultText.text = Translations.id_auto_tune_result.arg(okBlocks).arg(blocks);
+        }
+    }
+
     onReset: {
         ParserSettingsModel.restoreDefaultSettings();
     }
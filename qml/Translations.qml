@@ -31,6 +31,7 @@ QtObject {
     property string id_left_channel_menu_item:               qsTrId("id_left_channel_menu_item") + TranslationManager.translationChanged
     property string id_right_channel_menu_item:              qsTrId("id_right_channel_menu_item") + TranslationManager.translationChanged
     property string id_save_waveform_menu_item:              qsTrId("id_save_waveform_menu_item") + TranslationManager.translationChanged
+    property string id_compress_waveform_menu_item:          qsTrId("id_compress_waveform_menu_item") + TranslationManager.translationChanged
     property string id_exit_menu_item:                       qsTrId("id_exit_menu_item") + TranslationManager.translationChanged
     property string id_waveform_menu_item:                   qsTrId("id_waveform_menu_item") + TranslationManager.translationChanged
     property string id_restore_view_menu_item:               qsTrId("id_restore_view_menu_item") + TranslationManager.translationChanged
@@ -104,4 +105,15 @@ QtObject {
     property string id_play_parsed_data:                     qsTrId("id_play_parsed_data") + TranslationManager.translationChanged
     property string id_stop_playing_parsed_data:             qsTrId("id_stop_playing_parsed_data") + TranslationManager.translationChanged
     property string id_playing_parsed_data_window_header:    qsTrId("id_playing_parsed_data_window_header") + TranslationManager.translationChanged
+    property string id_loading_file_window_header:           qsTrId("id_loading_file_window_header") + TranslationManager.translationChanged
+    property string id_auto_tune_settings:                   qsTrId("id_auto_tune_settings") + TranslationManager.translationChanged
+    property string id_auto_tuning_settings:                 qsTrId("id_auto_tuning_settings") + TranslationManager.translationChanged
+    property string id_auto_tune_result:                     qsTrId("id_auto_tune_result") + TranslationManager.translationChanged
+    property string id_bit_repair_menu_item:                 qsTrId("id_bit_repair_menu_item") + TranslationManager.translationChanged
+    property string id_bit_repair_window_header:             qsTrId("id_bit_repair_window_header") + TranslationManager.translationChanged
+    property string id_search_bit_repairs:                   qsTrId("id_search_bit_repairs") + TranslationManager.translationChanged
+    property string id_searching_bit_repairs:                qsTrId("id_searching_bit_repairs") + TranslationManager.translationChanged
+    property string id_flipped_bits:                         qsTrId("id_flipped_bits") + TranslationManager.translationChanged
+    property string id_bit_repair_cost:                      qsTrId("id_bit_repair_cost") + TranslationManager.translationChanged
+    property string id_bit_repair_block_outdated:            qsTrId("id_bit_repair_block_outdated") + TranslationManager.translationChanged
 }
@@ -121,6 +121,16 @@ ApplicationWindow {
                         saveFileDialog.open();
                     }
                 }
+
+                MenuItem {
+                    text: Translations.id_compress_waveform_menu_item
+                    checkable: true
+                    checked: WavReader.waveformCompression
+
+                    onToggled: {
+                        WavReader.waveformCompression = checked;
+                    }
+                }
             }
 
             MenuSeparator { }
@@ -155,6 +165,13 @@ ApplicationWindow {
                     parserSettingsDialog.open();
                 }
             }
+
+            MenuItem {
+                text: Translations.id_bit_repair_menu_item
+                onTriggered: {
+                    bitRepairDialog.open();
+                }
+            }
         }
 
         Menu {
@@ -234,19 +251,14 @@ ApplicationWindow {
                                : "WAV";
 
             console.log("Selected %1 file: ".arg(filetype) + openFileDialog.fileUrl);
+            //File is loaded asynchronously, the result is handled by onFileLoaded
             var res = (openDialogType === openFileDialog.openWfm
                         ? FileWorkerModel.openWaveformFileByUrl(openFileDialog.fileUrl)
                         : openDialogType === openFileDialog.openTap
                            ? FileWorkerModel.openTapFileByUrl(openFileDialog.fileUrl)
                            : FileWorkerModel.openWavFileByUrl(openFileDialog.fileUrl));
 
-            console.log("Open %1 file result: ".arg(filetype) + res);
-            if (res === 0) {
-                if (openDialogType !== openFileDialog.openWfm) {
-                    SuspiciousPointsModel.clearSuspiciousPoints();
-                }
-                restoreWaveformView();
-            }
+            console.log("Start loading %1 file result: ".arg(filetype) + res);
         }
 
         onRejected: {
@@ -287,8 +299,37 @@ ApplicationWindow {
     Connections {
         target: FileWorkerModel
         function onWavFileNameChanged() {
-            waveformControlCh0.reparse();
-            waveformControlCh1.reparse();
+            WaveformParser.parseAll();
+            waveformControlCh0.update();
+            waveformControlCh1.update();
+        }
+
+        function onLoadingChanged() {
+            if (FileWorkerModel.loading) {
+                fileLoadingDialog.open();
+            }
+            else {
+                fileLoadingDialog.close();
+            }
+        }
+
+        function onFileLoaded(result) {
+            console.log("Open file result: " + result);
+            if (result === 0) {
+                if (openFileDialog.openDialogType !== openFileDialog.openWfm) {
+                    SuspiciousPointsModel.clearSuspiciousPoints();
+                }
+                restoreWaveformView();
+            }
+        }
+    }
+
+    Connections {
+        target: WaveformParser
+        function onSettingsAutoTuned() {
+            WaveformParser.parseAll();
+            waveformControlCh0.update();
+            waveformControlCh1.update();
         }
     }
 
@@ -545,8 +586,9 @@ ApplicationWindow {
 
             onClicked: {
                 var parsedDataViewIdx = parsedDataView.currentRow;
-                waveformControlCh0.reparse();
-                waveformControlCh1.reparse();
+                WaveformParser.parseAll();
+                waveformControlCh0.update();
+                waveformControlCh1.update();
                 parsedDataView.selection.select(parsedDataViewIdx);
                 parsedDataView.currentRow = parsedDataViewIdx;
             }
@@ -859,7 +901,7 @@ ApplicationWindow {
                     MouseArea {
                         anchors.fill: parent
                         onClicked: {
-                            WaveformParser.toggleBlockSelection(blkNumber);
+                            parsedDataView.model.toggleSelection(blkNumber);
                         }
                     }
                 }
@@ -893,7 +935,7 @@ ApplicationWindow {
             model: channelsComboBox.currentIndex === 0 ? WaveformParser.parsedChannel0 : WaveformParser.parsedChannel1
             itemDelegate: Text {
                 text: styleData.value
-                color: modelData.state === 0 ? "black" : "red"
+                color: model.state === 0 ? "black" : "red"
             }
         }
 
@@ -1046,6 +1088,18 @@ ApplicationWindow {
 
     ParserSettings {
         id: parserSettingsDialog
+        channelNumber: channelsComboBox.currentIndex
+    }
+
+    BitRepair {
+        id: bitRepairDialog
+        channelNumber: channelsComboBox.currentIndex
+        blockNumber: parsedDataView.currentRow
+        onBitsRepaired: {
+            WaveformParser.parseAll();
+            waveformControlCh0.update();
+            waveformControlCh1.update();
+        }
     }
 
     Frequency {
@@ -1057,6 +1111,10 @@ ApplicationWindow {
         }
     }
 
+    FileLoading {
+        id: fileLoadingDialog
+    }
+
     DataPlayer {
         id: dataPlayerDialog
 
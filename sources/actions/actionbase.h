@@ -14,7 +14,7 @@
 #ifndef ACTIONBASE_H
 #define ACTIONBASE_H
 
-#include "sources/defines.h"
+#include "sources/core/wavvector.h"
 #include <QString>
 #include <QSharedPointer>
 
@@ -12,6 +12,7 @@
 //*******************************************************************************
 
 #include "editsampleaction.h"
+#include "sources/core/waveformparser.h"
 #include "sources/models/waveformmodel.h"
 #include "sources/translations/translations.h"
 
@@ -26,7 +27,8 @@ bool EditSampleAction::apply() {
     auto wf { WaveFormModel::instance()->getChannel(channel()) };
     const bool valid { isActionValid(wf) };
     if (valid) {
-        wf->operator[](m_params.sample) = m_params.newValue;
+        wf->set(m_params.sample, m_params.newValue);
+        WaveformParser::instance()->markEdited(channel(), m_params.sample, m_params.sample);
     }
 
     return valid;
@@ -34,7 +36,8 @@ bool EditSampleAction::apply() {
 
 void EditSampleAction::undo() {
     auto wf { WaveFormModel::instance()->getChannel(channel()) };
-    wf->operator[](m_params.sample) = m_params.previousValue;
+    wf->set(m_params.sample, m_params.previousValue);
+    WaveformParser::instance()->markEdited(channel(), m_params.sample, m_params.sample);
 }
 
 bool EditSampleAction::isActionValid(const QSharedPointer<QWavVector>& wf) const {
@@ -0,0 +1,96 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "flipbitsaction.h"
+#include "sources/core/waveformparser.h"
+#include "sources/models/waveformmodel.h"
+#include "sources/translations/translations.h"
+#include <algorithm>
+#include <QtMath>
+#include <cmath>
+
+namespace {
+    //Returns the sample of the largest magnitude, so the replacing half-wave keeps the sign and amplitude of the original one
+    QWavVectorType getPeak(const QWavVector& wf, const ParsedData::WaveformPart& p)
+    {
+        QWavVectorType peak { 0 };
+        for (uint64_t i = p.begin; i <= p.end(); ++i) {
+            const auto val { wf.at(i) };
+            if (std::abs(val) > std::abs(peak)) {
+                peak = val;
+            }
+        }
+        return peak;
+    }
+
+    void appendHalfSine(QVector<QWavVectorType>& samples, uint32_t length, QWavVectorType peak)
+    {
+        for (uint32_t i = 0; i < length; ++i) {
+            samples.append(peak * std::sin(M_PI * (i + 0.5) / length));
+        }
+    }
+}
+
+FlipBitsAction::FlipBitsAction(int channel, const FlipBitsActionParams& params) :
+    ActionBase(channel, qtTrId(ID_FLIP_BITS_ACTION).arg(params.flips.size())),
+    m_params(params)
+{
+    //Bits are replaced from the last one, so the positions of the rest of them aren't moved
+    std::sort(m_params.flips.begin(), m_params.flips.end(), [](const BitRepairSolver::BitFlip& a, const BitRepairSolver::BitFlip& b) { return a.first.begin > b.first.begin; });
+}
+
+bool FlipBitsAction::apply() {
+    auto wf { WaveFormModel::instance()->getChannel(channel()) };
+    const bool valid { isActionValid(wf) };
+    if (valid) {
+        m_originalSamples.clear();
+        for (const auto& f: qAsConst(m_params.flips)) {
+            const auto begin { f.first.begin };
+            const auto count { static_cast<QWavVector::size_type>(f.second.end() - begin + 1) };
+            QVector<QWavVectorType> original;
+            original.reserve(count);
+            for (QWavVector::size_type i = 0; i < count; ++i) {
+                original.append(wf->at(begin + i));
+            }
+
+            const uint32_t firstLength { f.targetLength / 2 };
+            QVector<QWavVectorType> samples;
+            samples.reserve(f.targetLength);
+            appendHalfSine(samples, firstLength, getPeak(*wf, f.first));
+            appendHalfSine(samples, f.targetLength - firstLength, getPeak(*wf, f.second));
+
+            wf->replace(begin, count, samples);
+            m_originalSamples.append(original);
+        }
+        WaveformParser::instance()->markChanged(channel());
+    }
+
+    return valid;
+}
+
+void FlipBitsAction::undo() {
+    auto wf { WaveFormModel::instance()->getChannel(channel()) };
+    //Bits are restored from the first one, so every bit is at its original position by the time it's restored
+    for (int i = m_params.flips.size() - 1; i >= 0; --i) {
+        const auto& f { m_params.flips[i] };
+        wf->replace(f.first.begin, f.targetLength, m_originalSamples[i]);
+    }
+    WaveformParser::instance()->markChanged(channel());
+}
+
+bool FlipBitsAction::isActionValid(const QSharedPointer<QWavVector>& wf) const {
+    return ActionBase::isActionValid(wf) && std::all_of(m_params.flips.cbegin(), m_params.flips.cend(), [&wf](const BitRepairSolver::BitFlip& f) {
+        return f.targetLength > 1 && f.second.end() < static_cast<uint64_t>(wf->size());
+    });
+}
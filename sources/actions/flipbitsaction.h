@@ -0,0 +1,44 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef FLIPBITSACTION_H
+#define FLIPBITSACTION_H
+
+#include "actionbase.h"
+#include "sources/core/bitrepairsolver.h"
+
+struct FlipBitsActionParams {
+    QVector<BitRepairSolver::BitFlip> flips;
+};
+
+//Replaces the periods of the flipped bits by the sine periods of the opposite bit value,
+//so the following samples are moved by the difference of the period lengths
+class FlipBitsAction : public ActionBase
+{
+    FlipBitsActionParams m_params;
+    //Original samples of every flipped bit, the replacing period length is the target length of the flip
+    QVector<QVector<QWavVectorType>> m_originalSamples;
+
+public:
+    FlipBitsAction(int channel, const FlipBitsActionParams& params);
+    virtual ~FlipBitsAction() = default;
+
+    virtual bool apply() override;
+    virtual void undo() override;
+
+private:
+    virtual bool isActionValid(const QSharedPointer<QWavVector>& wf) const;
+};
+
+#endif // FLIPBITSACTION_H
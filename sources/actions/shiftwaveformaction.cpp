@@ -12,6 +12,7 @@
 //*******************************************************************************
 
 #include "shiftwaveformaction.h"
+#include "sources/core/waveformparser.h"
 #include "sources/models/waveformmodel.h"
 #include "sources/translations/translations.h"
 
@@ -26,16 +27,24 @@ bool ShiftWaveFormAction::apply() {
     auto wf { WaveFormModel::instance()->getChannel(channel()) };
     const bool valid { isActionValid(wf) };
     if (valid) {
-        std::for_each(wf->begin(), wf->end(), [this](QWavVectorType& itm) {
-            itm += m_params.offsetValue;
+        wf->visit([this](auto& samples) {
+            using T = typename std::decay_t<decltype(samples)>::value_type;
+            for (auto& itm: samples) {
+                itm = QWavVector::sampleCast<T>(itm + m_params.offsetValue);
+            }
         });
+        WaveformParser::instance()->markChanged(channel());
     }
     return valid;
 }
 
 void ShiftWaveFormAction::undo() {
     auto wf { WaveFormModel::instance()->getChannel(channel()) };
-    std::for_each(wf->begin(), wf->end(), [this](QWavVectorType& itm) {
-        itm -= m_params.offsetValue;
+    wf->visit([this](auto& samples) {
+        using T = typename std::decay_t<decltype(samples)>::value_type;
+        for (auto& itm: samples) {
+            itm = QWavVector::sampleCast<T>(itm - m_params.offsetValue);
+        }
     });
+    WaveformParser::instance()->markChanged(channel());
 }
@@ -0,0 +1,212 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "batchprocessor.h"
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+#include <cstring>
+#include "sources/core/waveformparser.h"
+#include "sources/models/parsedblocksmodel.h"
+
+namespace {
+    bool isWaveformFile(const QString& fileName)
+    {
+        return QFileInfo(fileName).suffix().compare("wfm", Qt::CaseInsensitive) == 0;
+    }
+}
+
+BatchProcessor::BatchProcessor() :
+    m_out(stdout),
+    m_err(stderr)
+{
+
+}
+
+bool BatchProcessor::isRequested(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--batch") == 0 || std::strcmp(argv[i], "-b") == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+BatchProcessor::ExitCode BatchProcessor::run(const QStringList& arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QString("Parses WAV/WFM files without GUI and saves the found blocks as TAP files.\n"
+                                             "Exit codes: %1 - all blocks are loaded without errors, %2 - some blocks have errors, "
+                                             "%3 - no blocks are found in some channel, %4 - some file can't be loaded or saved, %5 - invalid arguments.")
+                                     .arg(Success).arg(BlocksWithErrors).arg(NoBlocksFound).arg(InputError).arg(UsageError));
+    const auto helpOption { parser.addHelpOption() };
+    parser.addOption({ QStringList { "b", "batch" }, "Run without GUI." });
+    const QCommandLineOption channelOption { QStringList { "c", "channel" }, "Channel to parse: 0 (left), 1 (right) or all (default).", "channel", "all" };
+    parser.addOption(channelOption);
+    const QCommandLineOption outputDirOption { QStringList { "o", "output-dir" }, "Directory for the TAP files, the directory of every input file by default.", "directory" };
+    parser.addOption(outputDirOption);
+    parser.addPositionalArgument("files", "WAV or WFM files to parse.", "files...");
+
+    if (!parser.parse(arguments)) {
+        m_err << parser.errorText() << Qt::endl;
+        return UsageError;
+    }
+    if (parser.isSet(helpOption)) {
+        m_out << parser.helpText();
+        return Success;
+    }
+
+    const auto channel { parser.value(channelOption).toLower() };
+    if (channel == "0" || channel == "left") {
+        m_channels = { 0 };
+    }
+    else if (channel == "1" || channel == "right") {
+        m_channels = { 1 };
+    }
+    else if (channel != "all") {
+        m_err << "Invalid channel: " << parser.value(channelOption) << Qt::endl;
+        return UsageError;
+    }
+
+    m_outputDir = parser.value(outputDirOption);
+    if (!m_outputDir.isEmpty() && !QDir().mkpath(m_outputDir)) {
+        m_err << "Can't create output directory: " << m_outputDir << Qt::endl;
+        return UsageError;
+    }
+
+    const auto files { parser.positionalArguments() };
+    if (files.isEmpty()) {
+        m_err << "No input files are given" << Qt::endl << Qt::endl << parser.helpText();
+        return UsageError;
+    }
+
+    auto result { Success };
+    for (const auto& f: files) {
+        result = std::max(result, processFile(f));
+    }
+    return result;
+}
+
+WavReader::ErrorCodesEnum BatchProcessor::load(const QString& fileName) const
+{
+    auto& r = *WavReader::instance();
+    r.close();
+    if (isWaveformFile(fileName)) {
+        return r.loadWaveform(fileName);
+    }
+
+    //WAV file is only opened, its samples are decoded by the parsing
+    const auto result { r.setFileName(fileName) };
+    return result == WavReader::Ok ? r.open() : result;
+}
+
+WavReader::ErrorCodesEnum BatchProcessor::parse(const QString& fileName, const QVector<uint>& channels) const
+{
+    //WAV files are parsed by streaming, so their size isn't limited by the memory, waveform files are already decoded into the channels
+    auto& parser = *WaveformParser::instance();
+    if (!isWaveformFile(fileName)) {
+        return parser.parseStreamed();
+    }
+
+    const auto numberOfChannels { WavReader::instance()->getNumberOfChannels() };
+    for (auto ch: channels) {
+        if (ch < numberOfChannels) {
+            parser.parse(ch);
+        }
+    }
+    return WavReader::Ok;
+}
+
+BatchProcessor::ExitCode BatchProcessor::processFile(const QString& fileName)
+{
+    const auto loadResult { load(fileName) };
+    if (loadResult != WavReader::Ok) {
+        m_err << fileName << ": can't be loaded, error " << loadResult << Qt::endl;
+        return InputError;
+    }
+
+    const auto numberOfChannels { WavReader::instance()->getNumberOfChannels() };
+    QVector<uint> channels;
+    if (m_channels.isEmpty()) {
+        for (uint ch = 0; ch < numberOfChannels; ++ch) {
+            channels.append(ch);
+        }
+    }
+    else {
+        channels = m_channels;
+    }
+
+    const auto parseResult { parse(fileName, channels) };
+    if (parseResult != WavReader::Ok) {
+        m_err << fileName << ": can't be parsed, error " << parseResult << Qt::endl;
+        return InputError;
+    }
+
+    auto result { Success };
+    for (auto ch: channels) {
+        if (ch >= numberOfChannels) {
+            m_err << fileName << ": there is no channel " << ch << Qt::endl;
+            result = std::max(result, InputError);
+            continue;
+        }
+        result = std::max(result, processChannel(fileName, ch));
+    }
+    return result;
+}
+
+BatchProcessor::ExitCode BatchProcessor::processChannel(const QString& fileName, uint chNum)
+{
+    auto& parser = *WaveformParser::instance();
+    const auto snapshot { parser.getSnapshot(chNum) };
+    const auto& blocks { snapshot->blocks };
+    const auto tapFileName { getTapFileName(fileName, chNum) };
+    m_out << fileName << ", channel " << chNum << ": " << blocks.size() << " block(s)";
+    if (blocks.isEmpty()) {
+        m_out << Qt::endl;
+        return NoBlocksFound;
+    }
+    m_out << " -> " << tapFileName << Qt::endl;
+
+    //Texts of the rows are taken from the model, so the summary reads the same as the list of the blocks in GUI
+    const auto rows { parser.getParsedBlocksModel(chNum)->getRows() };
+    auto result { Success };
+    for (auto i = 0; i < rows.size(); ++i) {
+        const auto& r { rows.at(i) };
+        m_out << QString("%1  %2  %3  %4  %5")
+                 .arg(i, 4)
+                 .arg(r.blockType, -16)
+                 .arg(r.blockName, -10)
+                 .arg(r.blockSize.toString(), -14)
+                 .arg(r.blockStatus)
+              << Qt::endl;
+        if (blocks.at(i).state != ParsedData::OK) {
+            result = BlocksWithErrors;
+        }
+    }
+
+    if (!parser.saveTap(chNum, tapFileName)) {
+        m_err << tapFileName << ": can't be saved" << Qt::endl;
+        return InputError;
+    }
+    return result;
+}
+
+QString BatchProcessor::getTapFileName(const QString& fileName, uint chNum) const
+{
+    const QFileInfo fi(fileName);
+    const QDir dir(m_outputDir.isEmpty() ? fi.absolutePath() : m_outputDir);
+    return dir.filePath(QString("%1_%2.tap").arg(fi.completeBaseName()).arg(chNum ? "R" : "L"));
+}
@@ -0,0 +1,63 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include <QStringList>
+#include <QTextStream>
+#include "sources/core/wavreader.h"
+
+//Headless mode of the application: the given WAV/WFM files are parsed one by one and saved as TAP files,
+//the list of the parsed blocks is printed to the standard output. Only QCoreApplication is needed, so no QML is loaded.
+class BatchProcessor final
+{
+public:
+    //Codes are ordered by the severity, the most severe one met while processing the files is returned
+    enum ExitCode {
+        Success = 0,
+        BlocksWithErrors = 1,
+        NoBlocksFound = 2,
+        InputError = 3,
+        UsageError = 4
+    };
+
+private:
+    QTextStream m_out;
+    QTextStream m_err;
+    QVector<uint> m_channels; //Empty means every channel of the file
+    QString m_outputDir;
+
+    WavReader::ErrorCodesEnum load(const QString& fileName) const;
+    WavReader::ErrorCodesEnum parse(const QString& fileName, const QVector<uint>& channels) const;
+    ExitCode processFile(const QString& fileName);
+    ExitCode processChannel(const QString& fileName, uint chNum);
+    QString getTapFileName(const QString& fileName, uint chNum) const;
+
+public:
+    BatchProcessor();
+    ~BatchProcessor() = default;
+
+    BatchProcessor(const BatchProcessor& other) = delete;
+    BatchProcessor(BatchProcessor&& other) = delete;
+    BatchProcessor& operator= (const BatchProcessor& other) = delete;
+    BatchProcessor& operator= (BatchProcessor&& other) = delete;
+
+    ExitCode run(const QStringList& arguments);
+
+    //Checks the raw command line, so the kind of the application object may be chosen before it is created
+    static bool isRequested(int argc, char* argv[]);
+};
+
+#endif // BATCHPROCESSOR_H
@@ -179,9 +179,13 @@ bool ConfigurationManager::WaveformCustomization::checkVerticalRange() const {
 ConfigurationManager::ApplicationCustomization::ApplicationCustomization() :
     ConfigurationManager::CustomizationBase(m_applicationini),
     m_translationLanguage(TranslationManager::TranslationLanguages::en_US),
+    m_waveformCompression(false),
     m_applicationini({
         { INISections::TRANSLATION, {
               qMakePair(INIKeys::language, std::make_shared<INITranslationLanguageValue>(m_translationLanguage))
+        } },
+        { INISections::BEHAVIOR, {
+              qMakePair(INIKeys::waveformCompression, std::make_shared<INIBoolValue>(m_waveformCompression))
         } }
     })
 {
@@ -197,6 +201,14 @@ bool ConfigurationManager::ApplicationCustomization::setTranslationLanguage(Tran
     return true;
 }
 
+bool ConfigurationManager::ApplicationCustomization::waveformCompression() const {
+    return m_waveformCompression;
+}
+
+void ConfigurationManager::ApplicationCustomization::setWaveformCompression(bool compression) {
+    m_waveformCompression = compression;
+}
+
 
 //ConfigurationManager class
 ConfigurationManager::ConfigurationManager(QObject* parent) :
@@ -53,7 +53,8 @@ public:
         waveLineThickness,
         circleRadius,
         checkVerticalRange,
-        language
+        language,
+        waveformCompression
     };
     Q_ENUM(INIKeys)
 
@@ -173,6 +174,7 @@ public:
 
     class ApplicationCustomization : public CustomizationBase {
         TranslationManager::TranslationLanguages m_translationLanguage;
+        bool m_waveformCompression;
 
         const QMap<INISections, QList<QPair<INIKeys, std::shared_ptr<INIValueBase>>>> m_applicationini;
 
@@ -181,6 +183,8 @@ public:
 
         TranslationManager::TranslationLanguages translationLanguage() const;
         bool setTranslationLanguage(TranslationManager::TranslationLanguages lng);
+        bool waveformCompression() const;
+        void setWaveformCompression(bool compression);
     };
 
     ConfigurationManager(QObject* parent = nullptr);
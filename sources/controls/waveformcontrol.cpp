@@ -122,8 +122,16 @@ void WaveformControl::paint(QPainter* painter) {
     double y = py;
     const int xinc = getXScaleFactor() > 16.0 ? getXScaleFactor() / 16 : 1;
     double dx = (bRect.width() / (double) scale) * xinc;
-    const auto parsedWaveform = mWavParser.getParsedWaveform(m_channelNumber);
-    const auto parsedData = mWavParser.getParsedDataSharedPtr(m_channelNumber);
+    //Snapshot keeps the parsing result intact while it is painted
+    const auto snapshot = mWavParser.getSnapshot(m_channelNumber);
+    const auto& parsedWaveform = snapshot->spans;
+    //Only the spans intersecting the visible range are iterated, the samples are visited in ascending order
+    auto span = ParsedData::findSpan(parsedWaveform, std::max(pos, 0));
+    const auto& parsedData = snapshot->blocks;
+    //Block and byte of the markers are walked forward the same way, the byte is looked up once per block entered
+    auto block = ParsedData::findBlock(parsedData, std::max(pos, 0));
+    auto byteBlock = parsedData.cend();
+    int byte = 0;
     bool printHint = false;
     m_allowToGrabPoint = dx > 2;
     const auto chsize = channel->size();
@@ -133,7 +141,7 @@ void WaveformControl::paint(QPainter* painter) {
 
     for (int32_t t = pos; t < pos + scale; t += xinc) {
         if (t >= 0 && t < chsize) {
-            const int val = channel->operator[](t);
+            const int val = channel->at(t);
             y = halfHeight - ((double) (val) / maxy) * waveHeight;
             p.setWidth(m_customData.waveLineThickness());
             p.setColor(val >= 0 ? m_customData.wavePositiveColor() : m_customData.waveNegativeColor());
@@ -143,7 +151,10 @@ void WaveformControl::paint(QPainter* painter) {
                 painter->drawEllipse(QPoint(x, y), m_customData.circleRadius(), m_customData.circleRadius());
             }
 
-            const auto pwf = parsedWaveform[t];
+            while (span != parsedWaveform.cend() && span->end() < static_cast<uint64_t>(t)) {
+                ++span;
+            }
+            const auto pwf = span != parsedWaveform.cend() && span->begin <= static_cast<uint64_t>(t) ? span->getFlags(t) : 0;
             if (pwf & ParsedData::sequenceMiddle) {
                 p.setWidth(3);
                 painter->setPen(p);
@@ -182,11 +193,11 @@ void WaveformControl::paint(QPainter* painter) {
                     painter->setPen(p);
                     painter->drawLine(x, bRect.height() - 10, x, bRect.height() - 3);
 
-                    auto parsedIt = std::find_if(parsedData->begin(), parsedData->end(), [t](const ParsedData::DataBlock& db) {
-                        return t >= db.dataStart && t <= db.dataEnd;
-                    });
+                    while (block != parsedData.cend() && block->dataEnd < static_cast<uint64_t>(t)) {
+                        ++block;
+                    }
 
-                    if (parsedIt != parsedData->end()) {
+                    if (block != parsedData.cend() && block->dataStart <= static_cast<uint64_t>(t)) {
                         fnt.setPixelSize(9);
                         painter->setFont(fnt);
                         p.setWidth(1);
@@ -197,12 +208,20 @@ void WaveformControl::paint(QPainter* painter) {
                             return QString("0x%1").arg(QString("%1").arg(val, count, 16, QLatin1Char('0')).toUpper());
                         };
 
-                        const auto addrIt = (*parsedIt).dataMapping.find(t);
-                        if (addrIt != (*parsedIt).dataMapping.end()) {
+                        if (block != byteBlock) {
+                            byteBlock = block;
+                            byte = block->findByte(t);
+                        }
+                        while (byte < block->byteEnds.size() && block->getByteEnd(byte) < static_cast<uint64_t>(t)) {
+                            ++byte;
+                        }
+
+                        const int addr { byte };
+                        if (addr < block->data.size() && (seqBegin ? block->getByteBegin(addr) : block->getByteEnd(addr)) == static_cast<uint64_t>(t)) {
                             if (seqBegin) {
-                                painter->drawText(x + 5, bRect.height() - 6, toHexVal(*addrIt, *addrIt <= 65535 ? 4 : 6));
+                                painter->drawText(x + 5, bRect.height() - 6, toHexVal(addr, addr <= 65535 ? 4 : 6));
                             } else {
-                                painter->drawText(x - 5 - 19, bRect.height() - 6, toHexVal((*parsedIt).data[*addrIt], 2));
+                                painter->drawText(x - 5 - 19, bRect.height() - 6, toHexVal(block->data[addr], 2));
                             }
                         }
 
@@ -346,28 +365,30 @@ void WaveformControl::mousePressEvent(QMouseEvent* event)
         if (m_operationMode == WaveformRepairMode) {
             if (event->button() == Qt::MiddleButton) {
                 //const auto p = point + getWavePos();
-                const auto d = getChannel()->operator[](m_clickPosition);
+                const auto d = getChannel()->at(m_clickPosition);
                 qDebug() << "Inserting point: " << m_clickPosition;
                 getChannel()->insert(m_clickPosition + (dpoint > event->x() ? 1 : -1), d);
+                mWavParser.markChanged(m_channelNumber);
                 update();
             }
             else {
                 if (dpoint >= (event->x() - dx/2) && dpoint <= (event->x() + dx/2)) {
                     const double maxy = getYScaleFactor();
-                    auto initialVal { getChannel()->operator[](m_clickPosition) };
+                    auto initialVal { getChannel()->at(m_clickPosition) };
                     double y = halfHeight - ((double) (initialVal) / maxy) * waveHeight;
                     if (!m_customData.checkVerticalRange() || (y >= event->y() - 2 && y <= event->y() + 2)) {
                         if (event->button() == Qt::LeftButton) {
                             m_pointIndex = point;
                             m_initialValue = initialVal;
                             m_pointGrabbed = true;
-                            qDebug() << "Grabbed point: " << initialVal; //getChannel()->operator[](m_clickPosition);
+                            qDebug() << "Grabbed point: " << initialVal; //getChannel()->at(m_clickPosition);
                         }
                         else {
                             if (QGuiApplication::queryKeyboardModifiers() != Qt::ShiftModifier) {
                                 m_pointGrabbed = false;
                                 qDebug() << "Deleting point";
                                 getChannel()->remove(m_clickPosition);
+                                mWavParser.markChanged(m_channelNumber);
                                 update();
                             }
                         }
@@ -461,7 +482,8 @@ void WaveformControl::mouseMoveEvent(QMouseEvent* event)
                 double val = halfHeight + (m_yScaleFactor / waveHeight * pointerPos);
                 if (m_pointIndex + getWavePos() >= 0 && m_pointIndex + getWavePos() < ch->size()) {
                     m_newValue = val;
-                    getChannel()->operator[](m_pointIndex + getWavePos()) = val;
+                    getChannel()->set(m_pointIndex + getWavePos(), val);
+                    mWavParser.markEdited(m_channelNumber, m_pointIndex + getWavePos(), m_pointIndex + getWavePos());
                 }
                 qDebug() << "Setting point: " << m_pointIndex + getWavePos();
             }
@@ -484,7 +506,8 @@ void WaveformControl::mouseMoveEvent(QMouseEvent* event)
                 const double halfHeight = waveHeight / 2;
                 const auto pointerPosY = halfHeight - event->y();
                 double val = halfHeight + (m_yScaleFactor / waveHeight * pointerPosY);
-                getChannel()->operator[](m_clickPosition) = val;
+                getChannel()->set(m_clickPosition, val);
+                mWavParser.markEdited(m_channelNumber, m_clickPosition, m_clickPosition);
             }
             event->accept();
             update();
@@ -543,6 +566,7 @@ void WaveformControl::restoreWaveform()
 {
     if (m_isWaveformRepaired) {
         mWavReader.restoreWaveform(m_channelNumber);
+        mWavParser.markChanged(m_channelNumber);
         update();
         m_isWaveformRepaired = false;
         emit isWaveformRepairedChanged();
@@ -552,6 +576,7 @@ void WaveformControl::restoreWaveform()
 void WaveformControl::shiftWaveform()
 {
     mWavReader.shiftWaveform(m_channelNumber);
+    mWavParser.markChanged(m_channelNumber);
     update();
 }
 
@@ -561,9 +586,13 @@ void WaveformControl::copySelectedToAnotherChannel()
         uint destChNum = getChannelNumber() == 0 ? 1 : 0;
         const auto sourceChannel = getChannel();
         const auto destChannel = getChannel(&destChNum);
+        const auto beginIdx = getWavPositionByMouseX(m_selectionRange.first);
         const auto endIdx = getWavPositionByMouseX(m_selectionRange.second);
-        for (auto i = getWavPositionByMouseX(m_selectionRange.first); i <= endIdx; ++i) {
-            destChannel->operator[](i) = sourceChannel->operator[](i);
+        for (auto i = beginIdx; i <= endIdx; ++i) {
+            destChannel->set(i, sourceChannel->at(i));
+        }
+        if (beginIdx <= endIdx) {
+            mWavParser.markEdited(destChNum, beginIdx, endIdx);
         }
     }
 }
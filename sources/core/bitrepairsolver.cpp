@@ -0,0 +1,200 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "bitrepairsolver.h"
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace {
+    //Bit of the block with the syndrome bit it changes
+    struct Bit
+    {
+        BitRepairSolver::BitFlip flip;
+        uint8_t mask;
+    };
+
+    //Depth-first search of the flip sets starting with the given bit
+    class Search
+    {
+        const QVector<Bit>& m_bits;
+        const QElapsedTimer& m_timer;
+        const qint64 m_timeBudgetMs;
+        std::atomic<bool>& m_stopped;
+        QVector<int> m_chosen;
+        qint64 m_nodes;
+
+    public:
+        QVector<BitRepairSolver::Candidate> found;
+
+        Search(const QVector<Bit>& bits, const QElapsedTimer& timer, qint64 timeBudgetMs, std::atomic<bool>& stopped) :
+            m_bits(bits),
+            m_timer(timer),
+            m_timeBudgetMs(timeBudgetMs),
+            m_stopped(stopped),
+            m_nodes(0)
+        {
+
+        }
+
+        void run(int first, uint8_t syndrome)
+        {
+            m_chosen = { first };
+            run(first + 1, syndrome ^ m_bits[first].mask, m_bits[first].flip.margin);
+        }
+
+    private:
+        bool isFull() const
+        {
+            return found.size() >= BitRepairSolver::maxCandidates;
+        }
+
+        void store(double cost)
+        {
+            BitRepairSolver::Candidate c { { }, cost };
+            for (const auto i: qAsConst(m_chosen)) {
+                c.flips.append(m_bits[i].flip);
+            }
+            found.insert(std::upper_bound(found.begin(), found.end(), cost, [](double v, const BitRepairSolver::Candidate& f) { return v < f.cost; }), c);
+            if (found.size() > BitRepairSolver::maxCandidates) {
+                found.removeLast();
+            }
+        }
+
+        void run(int next, uint8_t syndrome, double cost)
+        {
+            if ((++m_nodes & 0xFFF) == 0 && m_timer.elapsed() >= m_timeBudgetMs) {
+                m_stopped = true;
+            }
+            if (m_stopped) {
+                return;
+            }
+
+            //Flipping more bits of the set which already fixes the parity can only make it worse
+            if (syndrome == 0) {
+                store(cost);
+                return;
+            }
+
+            //Every flip fixes no more than one bit of the parity
+            const int required { __builtin_popcount(syndrome) };
+            if (required > BitRepairSolver::maxFlips - m_chosen.size()) {
+                return;
+            }
+
+            for (int i = next; i < m_bits.size(); ++i) {
+                //Bits are ordered by the margin, so the rest of the sets starting from this bit can't be better
+                if (isFull() && cost + m_bits[i].flip.margin * required >= found.last().cost) {
+                    break;
+                }
+
+                m_chosen.append(i);
+                run(i + 1, syndrome ^ m_bits[i].mask, cost + m_bits[i].flip.margin);
+                m_chosen.removeLast();
+            }
+        }
+    };
+
+    //Returns the threshold period length between the zero and one data bits
+    double getThreshold(const HalfWaveClassifier& classifier)
+    {
+        const auto& settings { classifier.getSettings() };
+        const uint32_t zeroLength = std::lround(static_cast<double>(classifier.getSampleRate()) / settings.zeroFreq);
+        const uint32_t oneLength = std::lround(static_cast<double>(classifier.getSampleRate()) / settings.oneFreq);
+        //Zero is checked first, so the one bit starts where the zero ends if their ranges intersect
+        uint32_t zeroMax { zeroLength };
+        while (zeroMax < oneLength && classifier.is(zeroMax + 1, HalfWaveClassifier::zeroBit)) {
+            ++zeroMax;
+        }
+        uint32_t oneMin { zeroMax + 1 };
+        while (oneMin < oneLength && !classifier.is(oneMin, HalfWaveClassifier::oneBit)) {
+            ++oneMin;
+        }
+        return (zeroMax + oneMin) / 2.0;
+    }
+}
+
+BitRepairSolver::Result BitRepairSolver::solve(const ParsedData::DataBlock& block, const HalfWaveStore& halfWaves, const HalfWaveClassifier& classifier, qint64 timeBudgetMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    const uint8_t syndrome = block.parityCalculated ^ block.parityAwaited;
+    if (syndrome == 0 || block.data.isEmpty()) {
+        return { { }, true, true };
+    }
+
+    const auto& settings { classifier.getSettings() };
+    const double zeroLength { static_cast<double>(classifier.getSampleRate()) / settings.zeroFreq };
+    const double oneLength { static_cast<double>(classifier.getSampleRate()) / settings.oneFreq };
+    const double threshold { getThreshold(classifier) };
+
+    //Data bits are the half-wave pairs starting right after the synchro signal
+    auto it { halfWaves.lowerBound(block.dataStart) };
+    if (it == halfWaves.cend() || it->begin != block.dataStart || std::distance(it, halfWaves.cend()) < block.data.size() * 16) {
+        return { { }, true, false };
+    }
+
+    QVector<Bit> bits;
+    bits.reserve(block.data.size() * 8);
+    for (int byteIndex = 0; byteIndex < block.data.size(); ++byteIndex) {
+        for (uint8_t bitIndex = 0; bitIndex < 8; ++bitIndex, it += 2) {
+            const auto first { *it };
+            const auto second { *std::next(it) };
+            const bool isOne { (block.data[byteIndex] & (1 << (7 - bitIndex))) != 0 };
+            const uint32_t length { first.length + second.length };
+            const auto classes { classifier.classify(length) };
+            if (!(classes & (isOne ? HalfWaveClassifier::oneBit : HalfWaveClassifier::zeroBit))) {
+                return { { }, true, false };
+            }
+
+            const double margin { std::abs(length - threshold) / (oneLength - zeroLength) };
+            const uint32_t targetLength = std::lround(isOne ? zeroLength : oneLength);
+            bits.append({ { byteIndex, bitIndex, !isOne, first, second, targetLength, margin }, static_cast<uint8_t>(1 << (7 - bitIndex)) });
+        }
+    }
+
+    //Only the most ambiguous bits are searched
+    std::stable_sort(bits.begin(), bits.end(), [](const Bit& a, const Bit& b) { return a.flip.margin < b.flip.margin; });
+    if (bits.size() > maxSearchedBits) {
+        bits.resize(maxSearchedBits);
+    }
+
+    std::atomic<bool> stopped { false };
+    std::vector<Search> searches;
+    searches.reserve(bits.size());
+    for (int i = 0; i < bits.size(); ++i) {
+        searches.emplace_back(bits, timer, timeBudgetMs, stopped);
+    }
+    QVector<int> firsts(bits.size());
+    std::iota(firsts.begin(), firsts.end(), 0);
+    QtConcurrent::blockingMap(firsts, [&searches, syndrome](int& first) {
+        searches[first].run(first, syndrome);
+    });
+
+    Result result { { }, !stopped, true };
+    for (const auto& s: searches) {
+        result.candidates.append(s.found);
+    }
+    std::stable_sort(result.candidates.begin(), result.candidates.end(), [](const Candidate& a, const Candidate& b) { return a.cost < b.cost; });
+    if (result.candidates.size() > maxCandidates) {
+        result.candidates.resize(maxCandidates);
+    }
+
+    return result;
+}
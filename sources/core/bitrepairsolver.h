@@ -0,0 +1,70 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef BITREPAIRSOLVER_H
+#define BITREPAIRSOLVER_H
+
+#include <QVector>
+#include "sources/core/halfwaveclassifier.h"
+#include "sources/core/halfwavestore.h"
+#include "sources/core/parseddata.h"
+
+//Searches the data bits of the block with the parity error, flipping of which makes the parity correct.
+//Bits are ranked by how close their period was to the zero/one classification threshold, and only the most ambiguous of them
+//are searched. Flip sets are searched depth-first in parallel (one task per the first flipped bit), sets which can't fix
+//the remaining parity bits or can't be better than the already found ones are pruned.
+class BitRepairSolver final
+{
+public:
+    struct BitFlip
+    {
+        int byteIndex;
+        //Bit index from the most significant bit, the same order the bits are stored in the waveform
+        uint8_t bitIndex;
+        bool toOne;
+        //Half-waves of the bit and the period length of the opposite bit value
+        ParsedData::WaveformPart first;
+        ParsedData::WaveformPart second;
+        uint32_t targetLength;
+        //Distance of the bit period from the threshold relative to the distance between the zero and one periods
+        double margin;
+    };
+
+    struct Candidate
+    {
+        QVector<BitFlip> flips;
+        double cost;
+    };
+
+    struct Result
+    {
+        QVector<Candidate> candidates;
+        //Search is incomplete if it's stopped by the time budget
+        bool complete;
+        //Block doesn't match the half-waves if it's parsed from the other waveform or settings, so it should be parsed again
+        bool valid;
+    };
+
+    static constexpr const int maxSearchedBits = 64;
+    static constexpr const int maxFlips = 4;
+    static constexpr const int maxCandidates = 16;
+
+    BitRepairSolver() = delete;
+
+    //Returns the flip sets ordered by the cost (sum of the margins of flipped bits), the block should be parsed with the classifier
+    //from the half-waves given, otherwise no candidates are returned and the result isn't valid
+    static Result solve(const ParsedData::DataBlock& block, const HalfWaveStore& halfWaves, const HalfWaveClassifier& classifier, qint64 timeBudgetMs);
+};
+
+#endif // BITREPAIRSOLVER_H
@@ -0,0 +1,63 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "halfwaveclassifier.h"
+#include "sources/defines.h"
+
+HalfWaveClassifier::HalfWaveClassifier(const ParserSettingsModel::ParserSettings& settings, uint32_t sampleRate) :
+    m_settings(settings),
+    m_sampleRate(sampleRate),
+    m_classes(sampleRate + 2)
+{
+    //Length of zero has no frequency, so it has no class
+    for (uint32_t length = 1; length < static_cast<uint32_t>(m_classes.size()); ++length) {
+        uint8_t classes { 0 };
+        if (isFreqFitsInDelta(sampleRate, length, settings.pilotHalfFreq, settings.pilotDelta, 1.0)) {
+            classes |= pilotHalf;
+        }
+        if (isFreqFitsInDelta(sampleRate, length, settings.synchroFirstHalfFreq, settings.synchroDelta, 1.0)) {
+            classes |= synchroFirstHalf;
+        }
+        if (isFreqFitsInDelta(sampleRate, length, settings.synchroSecondHalfFreq, settings.synchroDelta, 1.0)) {
+            classes |= synchroSecondHalf;
+        }
+        if (isFreqFitsInDelta(sampleRate, length, settings.synchroFreq, settings.synchroDelta, 1.0)) {
+            classes |= synchro;
+        }
+        //Sine of any half-wave is normal if it isn't checked
+        if (!settings.checkForAbnormalSine || isFreqFitsInDelta(sampleRate, length, settings.zeroHalfFreq, settings.zeroDelta, settings.sineCheckTolerance)) {
+            classes |= zeroHalfSine;
+        }
+        if (!settings.checkForAbnormalSine || isFreqFitsInDelta(sampleRate, length, settings.oneHalfFreq, settings.oneDelta, settings.sineCheckTolerance)) {
+            classes |= oneHalfSine;
+        }
+        if (isFreqFitsInDelta2(sampleRate, length, settings.zeroFreq, settings.zeroDelta, HARDCODED_DATA_SIGNAL_DELTA)) {
+            classes |= zeroBit;
+        }
+        if (isFreqFitsInDelta2(sampleRate, length, settings.oneFreq, HARDCODED_DATA_SIGNAL_DELTA, settings.oneDelta)) {
+            classes |= oneBit;
+        }
+        m_classes[length] = classes;
+    }
+}
+
+const ParserSettingsModel::ParserSettings& HalfWaveClassifier::getSettings() const
+{
+    return m_settings;
+}
+
+uint32_t HalfWaveClassifier::getSampleRate() const
+{
+    return m_sampleRate;
+}
@@ -0,0 +1,69 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef HALFWAVECLASSIFIER_H
+#define HALFWAVECLASSIFIER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <QVector>
+#include "sources/models/parsersettingsmodel.h"
+
+#define HARDCODED_DATA_SIGNAL_DELTA 0.75
+
+//Lookup table of the signal classes by the half-wave (or the whole period) length.
+//Frequency checks depend on the length only through the integer frequency `sampleRate / length`, so the classes are computed
+//once for every length up to the sample rate, all of the longer half-waves have zero frequency and share the last entry.
+class HalfWaveClassifier final
+{
+public:
+    // |------------------------------- 1 - one data bit period
+    // | |----------------------------- 1 - zero data bit period
+    // | | |--------------------------- 1 - half-wave of the one data bit has normal sine
+    // | | | |------------------------- 1 - half-wave of the zero data bit has normal sine
+    // | | | | |----------------------- 1 - synchro signal period
+    // | | | | | |--------------------- 1 - second half of synchro signal
+    // | | | | | | |------------------- 1 - first half of synchro signal
+    // | | | | | | | |----------------- 1 - half of pilot tone
+    // x x x x x x x x
+
+    static constexpr const uint8_t pilotHalf         = 0b00000001;
+    static constexpr const uint8_t synchroFirstHalf  = 0b00000010;
+    static constexpr const uint8_t synchroSecondHalf = 0b00000100;
+    static constexpr const uint8_t synchro           = 0b00001000;
+    static constexpr const uint8_t zeroHalfSine      = 0b00010000;
+    static constexpr const uint8_t oneHalfSine       = 0b00100000;
+    static constexpr const uint8_t zeroBit           = 0b01000000;
+    static constexpr const uint8_t oneBit            = 0b10000000;
+
+    HalfWaveClassifier(const ParserSettingsModel::ParserSettings& settings, uint32_t sampleRate);
+
+    __attribute__((always_inline)) inline uint8_t classify(uint32_t length) const {
+        return m_classes[std::min<uint32_t>(length, m_classes.size() - 1)];
+    }
+
+    __attribute__((always_inline)) inline bool is(uint32_t length, uint8_t classes) const {
+        return (classify(length) & classes) != 0;
+    }
+
+    const ParserSettingsModel::ParserSettings& getSettings() const;
+    uint32_t getSampleRate() const;
+
+private:
+    const ParserSettingsModel::ParserSettings m_settings;
+    const uint32_t m_sampleRate;
+    QVector<uint8_t> m_classes;
+};
+
+#endif // HALFWAVECLASSIFIER_H
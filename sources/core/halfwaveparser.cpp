@@ -0,0 +1,211 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#include "halfwaveparser.h"
+
+HalfWaveParser::HalfWaveParser(ParsedData& parsedData, const HalfWaveClassifier& classifier) :
+    m_parsedData(parsedData),
+    m_classifier(classifier),
+    m_preciseSynchroCheck(classifier.getSettings().preciseSynchroCheck),
+    m_state(SEARCH_OF_PILOT_TONE),
+    m_firstHalf { },
+    m_hasFirstHalf(false),
+    m_dataStart(0),
+    m_bitIndex(0),
+    m_bit(0),
+    m_parity(0)
+{
+
+}
+
+bool HalfWaveParser::isPilotHalfFreq(const ParsedData::WaveformPart& p) const
+{
+    return m_classifier.is(p.length, HalfWaveClassifier::pilotHalf);
+}
+
+bool HalfWaveParser::isSynchroFirstHalfFreq(const ParsedData::WaveformPart& p) const
+{
+    return m_classifier.is(p.length, HalfWaveClassifier::synchroFirstHalf);
+}
+
+bool HalfWaveParser::isSynchroSecondHalfFreq(const ParsedData::WaveformPart& p) const
+{
+    return m_classifier.is(p.length, HalfWaveClassifier::synchroSecondHalf);
+}
+
+bool HalfWaveParser::isSineNormal(const ParsedData::WaveformPart& b, const ParsedData::WaveformPart& e, bool zeroCheck) const
+{
+    //Both half-waves have normal sine for any length if the check is off
+    const auto sine { zeroCheck ? HalfWaveClassifier::zeroHalfSine : HalfWaveClassifier::oneHalfSine };
+    return m_classifier.is(b.length, sine) && m_classifier.is(e.length, sine);
+}
+
+void HalfWaveParser::markPilotTone()
+{
+    //Pilot tone span is the last one while the synchro signal is searched, so only the begin and end bounds are set
+    m_parsedData.markLastSpan(ParsedData::sequenceBegin, ParsedData::sequenceEnd);
+}
+
+void HalfWaveParser::parseBit(const ParsedData::WaveformPart& b, const ParsedData::WaveformPart& e)
+{
+    const auto classes { m_classifier.classify(b.length + e.length) };
+    //"0" - ZERO
+    const bool isZero { (classes & HalfWaveClassifier::zeroBit) && isSineNormal(b, e, true) };
+    // "1" - ONE
+    const bool isOne { !isZero && (classes & HalfWaveClassifier::oneBit) && isSineNormal(b, e, false) };
+    if (!isZero && !isOne) {
+        //End of data, the pilot tone is searched starting from the next half-wave
+        m_state = SEARCH_OF_PILOT_TONE;
+        if (!m_data.empty()) {
+            storeData(e.end());
+        }
+        return;
+    }
+
+    //Mark parsed waveform as data bit and sets the begin and end bounds
+    m_parsedData.appendSpan(b, e, isZero ? ParsedData::zeroBit : ParsedData::oneBit,
+                            ParsedData::sequenceBegin | (m_bitIndex == 0 ? ParsedData::byteBound : 0),
+                            ParsedData::sequenceEnd | (m_bitIndex == 7 ? ParsedData::byteBound : 0));
+
+    if (m_bitIndex == 0) {
+        m_byteBegins.append(b.begin - m_dataStart);
+    }
+
+    //Set the currently parsed bit
+    if (isOne) {
+        m_bit |= 1 << (7 - m_bitIndex);
+    }
+
+    if (m_bitIndex++ == 7) {
+        m_byteEnds.append(e.end() - m_dataStart);
+        //Store parsed byte in data buffer
+        m_bitIndex = 0;
+        m_data.append(m_bit);
+        m_parity ^= m_bit;
+        m_bit = 0;
+    }
+}
+
+void HalfWaveParser::storeData(uint64_t end)
+{
+    m_parity ^= m_data.last(); //Removing parity byte from overal parity check sum
+    //Storing parsed data
+    m_parsedData.storeData(std::move(m_data), std::move(m_byteBegins), std::move(m_byteEnds), m_dataStart, end, m_parity);
+    m_data.clear();
+    m_byteBegins.clear();
+    m_byteEnds.clear();
+    m_parity = 0;
+}
+
+void HalfWaveParser::operator()(const ParsedData::WaveformPart& p)
+{
+    switch (m_state) {
+    case SEARCH_OF_PILOT_TONE:
+        if (isPilotHalfFreq(p)) {
+            //Mark parsed waveform as pilot-tone
+            m_parsedData.appendSpan(p, p, ParsedData::pilotTone);
+            m_state = PILOT_TONE;
+        }
+        break;
+
+    case PILOT_TONE:
+        if (isPilotHalfFreq(p)) {
+            m_parsedData.extendLastSpan(p);
+        }
+        else if (!m_preciseSynchroCheck) {
+            //The whole synchro signal period is checked, so the decision is postponed until its second half
+            m_firstHalf = p;
+            m_hasFirstHalf = true;
+            m_state = PILOT_TONE_END;
+        }
+        else if (isSynchroFirstHalfFreq(p)) {
+            //Found the first half of SYNCHRO signal
+            markPilotTone();
+            m_firstHalf = p;
+            m_hasFirstHalf = true;
+            m_state = SYNCHRO_SIGNAL;
+        }
+        else {
+            m_state = SEARCH_OF_PILOT_TONE;
+            (*this)(p);
+        }
+        break;
+
+    case PILOT_TONE_END: {
+        const auto firstHalf { m_firstHalf };
+        if (m_classifier.is(firstHalf.length + p.length, HalfWaveClassifier::synchro)) {
+            markPilotTone();
+            m_state = SYNCHRO_SIGNAL;
+            (*this)(p);
+        }
+        else {
+            //Both half-waves are searched for the pilot tone again
+            m_hasFirstHalf = false;
+            m_state = SEARCH_OF_PILOT_TONE;
+            (*this)(firstHalf);
+            (*this)(p);
+        }
+        break;
+    }
+
+    case SYNCHRO_SIGNAL:
+        m_hasFirstHalf = false;
+        //Check for second half of SYNCHRO signal or if `preciseSynchroCheck` option is off - assume there is synchro, because we did the check on the previous step
+        if (!m_preciseSynchroCheck || isSynchroSecondHalfFreq(p)) {
+            //Mark parsed waveform as syncro signal and sets the begin and end bounds
+            m_parsedData.appendSpan(m_firstHalf, p, ParsedData::synchroSignal, ParsedData::sequenceBegin, ParsedData::sequenceEnd);
+
+            //Initializing the currently parsing data block, which starts right after the synchro signal
+            m_state = DATA_SIGNAL;
+            m_dataStart = p.begin + p.length;
+            m_data.clear();
+            m_byteBegins.clear();
+            m_byteEnds.clear();
+            m_bitIndex = 0;
+            m_bit = 0;
+        }
+        else {
+            //Got the synchro error
+            m_state = SEARCH_OF_PILOT_TONE;
+            (*this)(p);
+        }
+        break;
+
+    case DATA_SIGNAL:
+        if (m_hasFirstHalf) {
+            m_hasFirstHalf = false;
+            parseBit(m_firstHalf, p);
+        }
+        else {
+            m_firstHalf = p;
+            m_hasFirstHalf = true;
+        }
+        break;
+    }
+}
+
+bool HalfWaveParser::isAtRest() const
+{
+    return m_state == SEARCH_OF_PILOT_TONE && !m_hasFirstHalf;
+}
+
+void HalfWaveParser::finish()
+{
+    if (m_state == DATA_SIGNAL && m_hasFirstHalf && !m_data.empty()) {
+        //Data block ends with the unpaired half-wave
+        storeData(m_firstHalf.end());
+    }
+
+    m_hasFirstHalf = false;
+    m_state = SEARCH_OF_PILOT_TONE;
+}
@@ -0,0 +1,65 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#ifndef HALFWAVEPARSER_H
+#define HALFWAVEPARSER_H
+
+#include <QVector>
+#include "sources/core/halfwaveclassifier.h"
+#include "sources/core/parseddata.h"
+
+//Pilot tone/synchro signal/data state machine.
+//Half-waves are pushed one by one right after their zero crossings are found, so the half-waves
+//of the whole channel are never kept in memory. Parsed waveform spans and data blocks are stored to the ParsedData.
+class HalfWaveParser final
+{
+    enum StateType { SEARCH_OF_PILOT_TONE, PILOT_TONE, PILOT_TONE_END, SYNCHRO_SIGNAL, DATA_SIGNAL };
+
+    ParsedData& m_parsedData;
+    const HalfWaveClassifier& m_classifier;
+    const bool m_preciseSynchroCheck;
+
+    StateType m_state;
+    //First half of the synchro signal or of the data bit which waits for its second half
+    ParsedData::WaveformPart m_firstHalf;
+    bool m_hasFirstHalf;
+
+    uint64_t m_dataStart;
+    QVector<uint8_t> m_data;
+    QVector<uint32_t> m_byteBegins;
+    QVector<uint32_t> m_byteEnds;
+    uint8_t m_bitIndex;
+    uint8_t m_bit;
+    uint8_t m_parity;
+
+    bool isPilotHalfFreq(const ParsedData::WaveformPart& p) const;
+    bool isSynchroFirstHalfFreq(const ParsedData::WaveformPart& p) const;
+    bool isSynchroSecondHalfFreq(const ParsedData::WaveformPart& p) const;
+    bool isSineNormal(const ParsedData::WaveformPart& b, const ParsedData::WaveformPart& e, bool zeroCheck) const;
+
+    void markPilotTone();
+    void parseBit(const ParsedData::WaveformPart& b, const ParsedData::WaveformPart& e);
+    void storeData(uint64_t end);
+
+public:
+    //Classifier should outlive the parser
+    HalfWaveParser(ParsedData& parsedData, const HalfWaveClassifier& classifier);
+
+    void operator()(const ParsedData::WaveformPart& p);
+    //Returns true if no signal is being parsed, so the following half-waves are parsed the same way regardless of the preceding ones
+    bool isAtRest() const;
+    //Completes the parsing, should be called after the last half-wave is pushed
+    void finish();
+};
+
+#endif // HALFWAVEPARSER_H
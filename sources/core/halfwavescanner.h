@@ -0,0 +1,97 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#ifndef HALFWAVESCANNER_H
+#define HALFWAVESCANNER_H
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include "sources/core/parseddata.h"
+#include "sources/core/zerocrossingdetector.h"
+#include "sources/defines.h"
+
+//Incremental zero-crossing detector.
+//Channel data may be fed by consecutive windows of samples, the half-wave which crosses the window bound is carried to the next window.
+//Every half-wave is passed to the consumer as soon as its end is found.
+template <typename Consumer>
+class HalfWaveScanner final
+{
+    static constexpr const size_t crossingsBlockSize = 4096;
+
+    Consumer m_consumer;
+    uint64_t m_position;
+    uint64_t m_partBegin;
+    bool m_negative;
+
+    void appendPart(uint64_t end) {
+        ParsedData::WaveformPart part;
+        part.sign = m_negative ? ParsedData::NEGATIVE : ParsedData::POSITIVE;
+        //Half-wave length is 32-bit, so the extremely long runs of the same sign are split into several parts
+        while (end > m_partBegin) {
+            part.begin = m_partBegin;
+            part.length = static_cast<uint32_t>(std::min<uint64_t>(end - m_partBegin, std::numeric_limits<uint32_t>::max()));
+            m_consumer(part);
+
+            m_partBegin += part.length;
+        }
+    }
+
+public:
+    //Scanning may be started from any sample position, which is expected to be the zero crossing
+    explicit HalfWaveScanner(Consumer consumer, uint64_t position = 0) :
+        m_consumer(std::forward<Consumer>(consumer)),
+        m_position(position),
+        m_partBegin(position),
+        m_negative(false)
+    {
+
+    }
+
+    template <typename T>
+    void feed(const T* data, size_t size) {
+        if (size == 0) {
+            return;
+        }
+
+        //Nothing is scanned yet
+        if (m_position == m_partBegin) {
+            m_negative = lessThanZero(data[0]);
+        }
+
+        //Sign changes are detected by blocks with the vectorized kernel, so the buffer of their indexes stays small
+        const auto detect { ZeroCrossingDetector::getDetectFunction<T>() };
+        uint32_t crossings[crossingsBlockSize];
+        for (size_t block = 0; block < size; block += crossingsBlockSize) {
+            const size_t count { detect(data + block, std::min(crossingsBlockSize, size - block), m_negative, crossings) };
+            for (size_t i = 0; i < count; ++i) {
+                appendPart(m_position + block + crossings[i]);
+                m_negative = !m_negative;
+            }
+        }
+        m_position += size;
+    }
+
+    //Stores the last half-wave, should be called after the last window is fed
+    void finish() {
+        if (m_position > m_partBegin) {
+            appendPart(m_position);
+        }
+    }
+
+    uint64_t position() const {
+        return m_position;
+    }
+};
+
+#endif // HALFWAVESCANNER_H
@@ -0,0 +1,123 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "halfwavestore.h"
+#include <algorithm>
+
+HalfWaveStore::HalfWaveStore() :
+    m_end(0),
+    m_firstSign(ParsedData::POSITIVE)
+{
+
+}
+
+uint32_t HalfWaveStore::getLongLength(int index) const
+{
+    const auto it { std::lower_bound(m_longLengths.cbegin(), m_longLengths.cend(), index, [](const LongLength& l, int i) { return l.index < i; }) };
+    return it->length;
+}
+
+ParsedData::WaveformSign HalfWaveStore::getSign(int index) const
+{
+    //Every sign repeat up to the half-wave inverts the alternation
+    const bool inverted = (index + findSignRepeat(index + 1)) & 1;
+    return inverted == (m_firstSign == ParsedData::NEGATIVE) ? ParsedData::POSITIVE : ParsedData::NEGATIVE;
+}
+
+int HalfWaveStore::findSignRepeat(int index) const
+{
+    return std::distance(m_signRepeats.cbegin(), std::lower_bound(m_signRepeats.cbegin(), m_signRepeats.cend(), index));
+}
+
+void HalfWaveStore::append(const ParsedData::WaveformPart& p)
+{
+    const int index { size() };
+    if (index == 0) {
+        m_firstSign = p.sign;
+        m_end = p.begin;
+    }
+    else if (getSign(index) != p.sign) {
+        m_signRepeats.append(index);
+    }
+
+    if (index % checkpointInterval == 0) {
+        m_checkpoints.append(m_end);
+    }
+    if (p.length >= longLengthMark) {
+        m_lengths.append(longLengthMark);
+        m_longLengths.append({ index, p.length });
+    }
+    else {
+        m_lengths.append(static_cast<uint16_t>(p.length));
+    }
+    m_end += p.length;
+}
+
+void HalfWaveStore::append(const HalfWaveStore& other)
+{
+    reserve(size() + other.size());
+    for (const auto& p: other) {
+        append(p);
+    }
+}
+
+void HalfWaveStore::reserve(int size)
+{
+    m_lengths.reserve(size);
+    m_checkpoints.reserve((size + checkpointInterval - 1) / checkpointInterval);
+}
+
+void HalfWaveStore::squeeze()
+{
+    m_lengths.squeeze();
+    m_checkpoints.squeeze();
+    m_longLengths.squeeze();
+    m_signRepeats.squeeze();
+}
+
+ParsedData::WaveformPart HalfWaveStore::at(int index) const
+{
+    const int checkpoint { index / checkpointInterval };
+    uint64_t begin { m_checkpoints[checkpoint] };
+    for (int i = checkpoint * checkpointInterval; i < index; ++i) {
+        begin += m_lengths[i] == longLengthMark ? getLength(i) : m_lengths[i];
+    }
+
+    ParsedData::WaveformPart p;
+    p.begin = begin;
+    p.length = getLength(index);
+    p.sign = getSign(index);
+    return p;
+}
+
+HalfWaveStore::const_iterator HalfWaveStore::lowerBound(uint64_t pos) const
+{
+    if (isEmpty() || pos >= m_end) {
+        return cend();
+    }
+
+    //Half-waves from the last checkpoint starting before the position are stepped through one by one
+    const int checkpoint = std::distance(m_checkpoints.cbegin(), std::upper_bound(m_checkpoints.cbegin(), m_checkpoints.cend(), pos)) - 1;
+    auto it { const_iterator(this, std::max(0, checkpoint) * checkpointInterval) };
+    while (it != cend() && it->begin < pos) {
+        ++it;
+    }
+    return it;
+}
+
+size_t HalfWaveStore::getMemoryUsage() const
+{
+    return m_lengths.capacity() * sizeof(uint16_t) + m_checkpoints.capacity() * sizeof(uint64_t)
+           + m_longLengths.capacity() * sizeof(LongLength) + m_signRepeats.capacity() * sizeof(int);
+}
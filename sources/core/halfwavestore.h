@@ -0,0 +1,161 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef HALFWAVESTORE_H
+#define HALFWAVESTORE_H
+
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <QVector>
+#include "sources/core/parseddata.h"
+
+//Compact storage of the consecutive half-waves found by the scanner.
+//Half-waves follow each other without gaps and their signs alternate, so only the start position, the first sign and the 16-bit lengths
+//are kept. Longer lengths and the rare sign repeats (the split of extremely long runs) are kept aside, and the start position
+//of every 64th half-wave is stored for the random access. Half-waves are decoded into ParsedData::WaveformPart on access.
+class HalfWaveStore final
+{
+    static constexpr const int checkpointInterval = 64;
+    static constexpr const uint16_t longLengthMark = 0xFFFF;
+
+    struct LongLength
+    {
+        int index;
+        uint32_t length;
+    };
+
+    uint64_t m_end;
+    ParsedData::WaveformSign m_firstSign;
+    QVector<uint16_t> m_lengths;
+    QVector<uint64_t> m_checkpoints;
+    QVector<LongLength> m_longLengths;
+    QVector<int> m_signRepeats;
+
+    uint32_t getLongLength(int index) const;
+    ParsedData::WaveformSign getSign(int index) const;
+    //Returns the position of the first sign repeat at the half-wave or after it in the list of repeats
+    int findSignRepeat(int index) const;
+
+    __attribute__((always_inline)) inline uint32_t getLength(int index) const {
+        const auto length { m_lengths[index] };
+        return length != longLengthMark ? length : getLongLength(index);
+    }
+
+public:
+    //Random access iterator decoding the half-waves, stepping forward by one half-wave doesn't touch the checkpoints
+    class const_iterator
+    {
+        const HalfWaveStore* m_store;
+        int m_index;
+        //Position of the next sign repeat after the current half-wave in the list of repeats and the index of its half-wave
+        int m_signRepeat;
+        int m_signRepeatIndex;
+        ParsedData::WaveformPart m_part;
+
+        void loadSignRepeat() {
+            m_signRepeatIndex = m_signRepeat < m_store->m_signRepeats.size() ? m_store->m_signRepeats[m_signRepeat] : std::numeric_limits<int>::max();
+        }
+
+        void load() {
+            if (m_index < m_store->size()) {
+                m_part = m_store->at(m_index);
+                m_signRepeat = m_store->findSignRepeat(m_index + 1);
+                loadSignRepeat();
+            }
+        }
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = ParsedData::WaveformPart;
+        using difference_type = int;
+        using pointer = const ParsedData::WaveformPart*;
+        using reference = ParsedData::WaveformPart;
+
+        const_iterator() : m_store(nullptr), m_index(0), m_signRepeat(0), m_signRepeatIndex(0), m_part { } { }
+        const_iterator(const HalfWaveStore* store, int index) : m_store(store), m_index(index), m_signRepeat(0), m_signRepeatIndex(0), m_part { } {
+            load();
+        }
+
+        reference operator*() const { return m_part; }
+        pointer operator->() const { return &m_part; }
+        reference operator[](difference_type n) const { return m_store->at(m_index + n); }
+        int index() const { return m_index; }
+
+        const_iterator& operator++() {
+            if (++m_index < m_store->size()) {
+                m_part.begin += m_part.length;
+                m_part.length = m_store->getLength(m_index);
+                if (m_index == m_signRepeatIndex) {
+                    ++m_signRepeat;
+                    loadSignRepeat();
+                }
+                else {
+                    m_part.sign = m_part.sign == ParsedData::NEGATIVE ? ParsedData::POSITIVE : ParsedData::NEGATIVE;
+                }
+            }
+            return *this;
+        }
+        const_iterator operator++(int) { auto t { *this }; ++*this; return t; }
+        const_iterator& operator--() { --m_index; load(); return *this; }
+        const_iterator operator--(int) { auto t { *this }; --*this; return t; }
+        const_iterator& operator+=(difference_type n) { m_index += n; load(); return *this; }
+        const_iterator& operator-=(difference_type n) { return *this += -n; }
+        const_iterator operator+(difference_type n) const { auto t { *this }; return t += n; }
+        const_iterator operator-(difference_type n) const { auto t { *this }; return t -= n; }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+        difference_type operator-(const const_iterator& other) const { return m_index - other.m_index; }
+
+        bool operator==(const const_iterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const const_iterator& other) const { return m_index != other.m_index; }
+        bool operator<(const const_iterator& other) const { return m_index < other.m_index; }
+        bool operator>(const const_iterator& other) const { return m_index > other.m_index; }
+        bool operator<=(const const_iterator& other) const { return m_index <= other.m_index; }
+        bool operator>=(const const_iterator& other) const { return m_index >= other.m_index; }
+    };
+
+    using size_type = int;
+
+    HalfWaveStore();
+
+    //Half-wave should start right after the last stored one
+    void append(const ParsedData::WaveformPart& p);
+    void append(const HalfWaveStore& other);
+    void reserve(int size);
+    void squeeze();
+
+    __attribute__((always_inline)) inline int size() const {
+        return m_lengths.size();
+    }
+    __attribute__((always_inline)) inline bool isEmpty() const {
+        return m_lengths.isEmpty();
+    }
+
+    ParsedData::WaveformPart at(int index) const;
+    ParsedData::WaveformPart operator[](int index) const {
+        return at(index);
+    }
+
+    const_iterator cbegin() const { return const_iterator(this, 0); }
+    const_iterator cend() const { return const_iterator(this, size()); }
+    const_iterator begin() const { return cbegin(); }
+    const_iterator end() const { return cend(); }
+
+    //Returns the first half-wave starting at the sample or after it
+    const_iterator lowerBound(uint64_t pos) const;
+    //Returns the number of bytes taken by the stored half-waves
+    size_t getMemoryUsage() const;
+};
+
+#endif // HALFWAVESTORE_H
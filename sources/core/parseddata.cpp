@@ -19,41 +19,119 @@ ParsedData::ParsedData(QObject* parent) :
     clear();
 }
 
-void ParsedData::clear(size_t size)
+void ParsedData::clear(bool markWaveform)
 {
-    mParsedWaveform.reset(new QVector<uint8_t>(size));
+    mMarkWaveform = markWaveform;
+    mParsedWaveform.reset(new QVector<WaveformSpan>());
     mParsedData.reset(new QVector<DataBlock>());
 }
 
-void ParsedData::fillParsedWaveform(const ParsedData::WaveformPart& p, uint8_t val)
+void ParsedData::startPartOf(const ParsedData& other)
 {
-    for (auto i = p.begin; i <= p.end; ++i) {
-        setParsedWaveform(i, val);
+    clear(other.mMarkWaveform);
+}
+
+void ParsedData::appendData(const ParsedData& other, int fromBlock, int fromSpan)
+{
+    const auto& data { *other.mParsedData };
+    for (auto i = fromBlock; i < data.size(); ++i) {
+        mParsedData->append(data.at(i));
+    }
+
+    const auto& spans { *other.mParsedWaveform };
+    mParsedWaveform->reserve(mParsedWaveform->size() + spans.size() - fromSpan);
+    for (auto i = fromSpan; i < spans.size(); ++i) {
+        mParsedWaveform->append(spans.at(i));
     }
 }
 
-void ParsedData::fillParsedWaveform(const ParsedData::WaveformPart& p, uint8_t val, size_t begin, uint8_t begin_val, size_t end, uint8_t end_val)
+void ParsedData::replaceData(int from, int count, const ParsedData& other)
+{
+    const auto& data { *mParsedData };
+    QVector<DataBlock> result;
+    result.reserve(data.size() - count + other.mParsedData->size());
+    result.append(data.mid(0, from));
+    result.append(*other.mParsedData);
+    result.append(data.mid(from + count));
+    *mParsedData = std::move(result);
+}
+
+void ParsedData::replaceSpans(uint64_t begin, uint64_t end, const ParsedData& other)
+{
+    const auto& spans { *mParsedWaveform };
+    const auto bySpanBegin { [](const WaveformSpan& s, uint64_t pos) { return s.begin < pos; } };
+    const int from = std::distance(spans.cbegin(), std::lower_bound(spans.cbegin(), spans.cend(), begin, bySpanBegin));
+    const int to = std::distance(spans.cbegin(), std::lower_bound(spans.cbegin(), spans.cend(), end, bySpanBegin));
+
+    QVector<WaveformSpan> result;
+    result.reserve(spans.size() - (to - from) + other.mParsedWaveform->size());
+    result.append(spans.mid(0, from));
+    result.append(*other.mParsedWaveform);
+    result.append(spans.mid(to));
+    *mParsedWaveform = std::move(result);
+}
+
+void ParsedData::appendSpan(const ParsedData::WaveformPart& begin, const ParsedData::WaveformPart& end, uint8_t kind, uint8_t beginFlags, uint8_t endFlags)
+{
+    if (!mMarkWaveform) {
+        return;
+    }
+
+    mParsedWaveform->append({ begin.begin, static_cast<uint32_t>(end.end() - begin.begin + 1), kind, beginFlags, endFlags });
+}
+
+void ParsedData::extendLastSpan(const ParsedData::WaveformPart& end)
+{
+    if (!mMarkWaveform) {
+        return;
+    }
+
+    auto& span { mParsedWaveform->last() };
+    span.length = end.end() - span.begin + 1;
+}
+
+void ParsedData::markLastSpan(uint8_t beginFlags, uint8_t endFlags)
+{
+    if (!mMarkWaveform) {
+        return;
+    }
+
+    auto& span { mParsedWaveform->last() };
+    span.beginFlags = beginFlags;
+    span.endFlags = endFlags;
+}
+
+ParsedData::SnapshotPtr ParsedData::makeSnapshot() const
+{
+    return SnapshotPtr::create(Snapshot { *mParsedData, *mParsedWaveform });
+}
+
+QVector<ParsedData::WaveformSpan>::const_iterator ParsedData::findSpan(const QVector<WaveformSpan>& spans, uint64_t pos)
+{
+    //Spans don't intersect, so their ends are ordered the same way as their begins
+    return std::lower_bound(spans.cbegin(), spans.cend(), pos, [](const WaveformSpan& s, uint64_t p) { return s.end() < p; });
+}
+
+QVector<ParsedData::DataBlock>::const_iterator ParsedData::findBlock(const QVector<DataBlock>& blocks, uint64_t pos)
 {
-    fillParsedWaveform(p, val);
-    setParsedWaveform(begin, begin_val);
-    setParsedWaveform(end, end_val);
+    return std::lower_bound(blocks.cbegin(), blocks.cend(), pos, [](const DataBlock& b, uint64_t p) { return b.dataEnd < p; });
 }
 
-void ParsedData::fillParsedWaveform(const ParsedData::WaveformPart& begin, const ParsedData::WaveformPart& end, uint8_t val, uint8_t begin_val, uint8_t end_val)
+uint8_t ParsedData::getSampleFlags(const QVector<WaveformSpan>& spans, uint64_t pos)
 {
-    fillParsedWaveform(begin, val);
-    fillParsedWaveform(end, val);
-    setParsedWaveform(begin.begin, begin_val);
-    setParsedWaveform(end.end, end_val);
+    const auto it { findSpan(spans, pos) };
+    return it != spans.cend() && it->begin <= pos ? it->getFlags(pos) : 0;
 }
 
-void ParsedData::storeData(QVector<uint8_t>&& data, QMap<size_t, uint>&& dataMapping, size_t begin, size_t end, QVector<ParsedData::WaveformPart>&& waveformData, uint8_t parity)
+void ParsedData::storeData(QVector<uint8_t>&& data, QVector<uint32_t>&& byteBegins, QVector<uint32_t>&& byteEnds, uint64_t begin, uint64_t end, uint8_t parity)
 {
     DataBlock db;
     db.dataStart = begin;
     db.dataEnd = end;
-    db.dataMapping = std::move(dataMapping);
-    db.waveformData = std::move(waveformData);
+    //Byte which isn't completed by the end of the data has no value
+    byteBegins.resize(data.size());
+    db.byteBegins = std::move(byteBegins);
+    db.byteEnds = std::move(byteEnds);
     //Storing parity data
     db.parityAwaited = data.last();
     db.parityCalculated = parity;
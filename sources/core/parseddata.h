@@ -16,7 +16,11 @@
 
 #include <QObject>
 #include <QSharedPointer>
-#include <QMap>
+#include <QVector>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 
 class ParsedData : public QObject
 {
@@ -45,50 +49,135 @@ public:
     enum WaveformSign { POSITIVE, NEGATIVE };
     enum DataState { OK, R_TAPE_LOADING_ERROR };
 
+    //Sample positions are 64-bit to address long RF64 captures, the half-wave length fits in 32 bits,
+    //so the part is still 16 bytes long.
     struct WaveformPart
     {
-        uint32_t begin;
-        uint32_t end;
+        uint64_t begin;
         uint32_t length;
         WaveformSign sign;
+
+        __attribute__((always_inline)) inline uint64_t end() const {
+            return begin + length - 1;
+        }
+    };
+
+    static_assert(sizeof(WaveformPart) == 16, "WaveformPart is expected to be 16 bytes long");
+
+    //Samples of the signal of one kind (pilot tone, synchro signal or data bit). Every sample of the span is the middle of the signal sequence
+    //except the first and the last ones, which have their own marks if their flags are set. Spans are ordered and don't intersect,
+    //the samples outside of the spans are not a part of any signal.
+    struct WaveformSpan
+    {
+        uint64_t begin;
+        uint32_t length;
+        uint8_t kind;
+        uint8_t beginFlags;
+        uint8_t endFlags;
+
+        __attribute__((always_inline)) inline uint64_t end() const {
+            return begin + length - 1;
+        }
+
+        //Returns the marks of the sample of the span, the end marks take precedence for the span of one sample
+        __attribute__((always_inline)) inline uint8_t getFlags(uint64_t pos) const {
+            if (pos == end() && endFlags != 0) {
+                return kind | endFlags;
+            }
+            if (pos == begin && beginFlags != 0) {
+                return kind | beginFlags;
+            }
+            return kind | sequenceMiddle;
+        }
     };
 
+    static_assert(sizeof(WaveformSpan) == 16, "WaveformSpan is expected to be 16 bytes long");
+
     struct DataBlock
     {
-        uint32_t dataStart;
-        uint32_t dataEnd;
+        uint64_t dataStart;
+        uint64_t dataEnd;
         QVector<uint8_t> data;
-        QMap<size_t, uint> dataMapping;
-        QVector<WaveformPart> waveformData;
+        //Offsets of the first and the last samples of every byte from the data start, both are ascending
+        QVector<uint32_t> byteBegins;
+        QVector<uint32_t> byteEnds;
         DataState state;
         uint8_t parityCalculated;
         uint8_t parityAwaited;
+
+        uint64_t getByteBegin(int byteIndex) const {
+            return dataStart + byteBegins[byteIndex];
+        }
+
+        uint64_t getByteEnd(int byteIndex) const {
+            return dataStart + byteEnds[byteIndex];
+        }
+
+        //Returns the first byte which ends at the sample or after it, or the number of bytes if there is no such byte
+        int findByte(uint64_t pos) const {
+            if (pos <= dataStart) {
+                return 0;
+            }
+            if (pos - dataStart > std::numeric_limits<uint32_t>::max()) {
+                return byteEnds.size();
+            }
+            return std::distance(byteEnds.cbegin(), std::lower_bound(byteEnds.cbegin(), byteEnds.cend(), static_cast<uint32_t>(pos - dataStart)));
+        }
+    };
+
+    //Immutable result of the parsing published to the readers. Vectors share their buffers with the parsed data,
+    //which detaches from them on the next change, so the readers may keep the snapshot on any thread.
+    struct Snapshot
+    {
+        QVector<DataBlock> blocks;
+        QVector<WaveformSpan> spans;
     };
+    using SnapshotPtr = QSharedPointer<const Snapshot>;
 
     explicit ParsedData(QObject* parent = nullptr);
     virtual ~ParsedData() override = default;
 
-    void storeData(QVector<uint8_t>&& data, QMap<size_t, uint>&& dataMapping, size_t begin, size_t end, QVector<ParsedData::WaveformPart>&& waveformData, uint8_t parity);
-    void clear(size_t size = 0);
-    void fillParsedWaveform(const ParsedData::WaveformPart& p, uint8_t val);
-    void fillParsedWaveform(const ParsedData::WaveformPart& p, uint8_t val, size_t begin, uint8_t begin_val, size_t end, uint8_t end_val);
-    void fillParsedWaveform(const ParsedData::WaveformPart& begin, const ParsedData::WaveformPart& end, uint8_t val, uint8_t begin_val, uint8_t end_val);
-    __attribute__((always_inline)) inline void setParsedWaveform(size_t pos, uint8_t val) {
-        mParsedWaveform.get()->operator [](pos) = val;
-    }
-    __attribute__((always_inline)) inline void orParsedWaveform(size_t pos, uint8_t val) {
-        mParsedWaveform.get()->operator [](pos) |= val;
+    void storeData(QVector<uint8_t>&& data, QVector<uint32_t>&& byteBegins, QVector<uint32_t>&& byteEnds, uint64_t begin, uint64_t end, uint8_t parity);
+    //Parsed data cleared without the waveform marking keeps no waveform spans, so only the data blocks are parsed into it
+    void clear(bool markWaveform = false);
+    //Starts the own lists of data blocks and waveform spans marked the same way as another parsed data,
+    //so the separate parts of the channel may be parsed at once and appended to it then
+    void startPartOf(const ParsedData& other);
+    void appendData(const ParsedData& other, int fromBlock = 0, int fromSpan = 0);
+    //Replaces `count` data blocks starting from `from` by all of the data blocks of another parsed data
+    void replaceData(int from, int count, const ParsedData& other);
+    //Replaces the waveform spans starting in the range of samples [begin, end) by all of the spans of another parsed data
+    void replaceSpans(uint64_t begin, uint64_t end, const ParsedData& other);
+
+    //Appends the span of the signal from the first sample of `begin` half-wave to the last sample of `end` half-wave
+    void appendSpan(const ParsedData::WaveformPart& begin, const ParsedData::WaveformPart& end, uint8_t kind, uint8_t beginFlags = 0, uint8_t endFlags = 0);
+    //Extends the last span up to the last sample of the half-wave
+    void extendLastSpan(const ParsedData::WaveformPart& end);
+    void markLastSpan(uint8_t beginFlags, uint8_t endFlags);
+
+    __attribute__((always_inline)) inline bool hasParsedWaveform() const {
+        return mMarkWaveform;
     }
 
     __attribute__((always_inline)) inline QSharedPointer<QVector<DataBlock>> getParsedData() const {
         return mParsedData;
     }
-    __attribute__((always_inline)) inline QSharedPointer<QVector<uint8_t>> getParsedWaveform() const {
+    __attribute__((always_inline)) inline QSharedPointer<QVector<WaveformSpan>> getParsedWaveform() const {
         return mParsedWaveform;
     }
+    SnapshotPtr makeSnapshot() const;
+
+    //Returns the first span which ends at the sample or after it, so all of the spans intersecting the range of samples
+    //starting from it are iterated from this span
+    static QVector<WaveformSpan>::const_iterator findSpan(const QVector<WaveformSpan>& spans, uint64_t pos);
+    //Returns the first data block which ends at the sample or after it, the blocks are ordered the same way as the spans
+    static QVector<DataBlock>::const_iterator findBlock(const QVector<DataBlock>& blocks, uint64_t pos);
+    //Returns the marks of the sample or zero if the sample is not a part of any signal
+    static uint8_t getSampleFlags(const QVector<WaveformSpan>& spans, uint64_t pos);
 
 private:
-    QSharedPointer<QVector<uint8_t>> mParsedWaveform;
+    bool mMarkWaveform;
+    QSharedPointer<QVector<WaveformSpan>> mParsedWaveform;
     QSharedPointer<QVector<DataBlock>> mParsedData;
 
 };
@@ -0,0 +1,133 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "parsersettingstuner.h"
+#include "sources/core/halfwaveclassifier.h"
+#include "sources/core/halfwaveparser.h"
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <iterator>
+
+namespace {
+    struct Variant
+    {
+        ParserSettingsModel::ParserSettings settings;
+        int okBlocks;
+        int blocks;
+    };
+
+    //Setting tuned and the range of its values
+    struct Dimension
+    {
+        double ParserSettingsModel::ParserSettings::* value;
+        double min;
+        double max;
+    };
+
+    const Dimension dimensions[] {
+        { &ParserSettingsModel::ParserSettings::pilotDelta, 0.02, 0.5 },
+        { &ParserSettingsModel::ParserSettings::synchroDelta, 0.05, 0.8 },
+        { &ParserSettingsModel::ParserSettings::zeroDelta, 0.05, 0.8 },
+        { &ParserSettingsModel::ParserSettings::oneDelta, 0.05, 0.8 },
+        { &ParserSettingsModel::ParserSettings::sineCheckTolerance, 0.25, 4.0 }
+    };
+
+    //Number of grid values on every side of the best value
+    const int gridSteps { 4 };
+    const double minGridSpan { 0.005 };
+
+    void evaluate(Variant& v, const HalfWaveStore& halfWaves, uint32_t sampleRate)
+    {
+        const HalfWaveClassifier classifier(v.settings, sampleRate);
+        ParsedData parsedData;
+        HalfWaveParser parser(parsedData, classifier);
+        for (const auto& p: halfWaves) {
+            parser(p);
+        }
+        parser.finish();
+
+        const auto& blocks { *parsedData.getParsedData() };
+        v.blocks = blocks.size();
+        v.okBlocks = std::count_if(blocks.cbegin(), blocks.cend(), [](const ParsedData::DataBlock& b) { return b.state == ParsedData::OK; });
+    }
+
+    //More correct blocks are better, and fewer erroneous blocks are better for the same number of correct ones
+    bool isBetter(const Variant& v, const Variant& best)
+    {
+        return v.okBlocks > best.okBlocks || (v.okBlocks == best.okBlocks && v.blocks - v.okBlocks < best.blocks - best.okBlocks);
+    }
+
+    //Loose settings may merge or lose the blocks, so all blocks are correct only if no variant has found more blocks
+    bool isAllCorrect(const Variant& v, int maxBlocks)
+    {
+        return v.blocks > 0 && v.okBlocks == v.blocks && v.blocks >= maxBlocks;
+    }
+}
+
+ParserSettingsTuner::Result ParserSettingsTuner::tune(const HalfWaveStore& halfWaves, const ParserSettingsModel::ParserSettings& initial, uint32_t sampleRate, qint64 timeBudgetMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    Variant best { initial, 0, 0 };
+    evaluate(best, halfWaves, sampleRate);
+    int variants { 1 };
+    int maxBlocks { best.blocks };
+
+    //Sine check tolerance doesn't affect the parsing if the sine isn't checked
+    const size_t dimensionsCount { std::size(dimensions) - (initial.checkForAbnormalSine ? 0 : 1) };
+    std::vector<double> spans;
+    for (size_t d = 0; d < dimensionsCount; ++d) {
+        spans.push_back((dimensions[d].max - dimensions[d].min) / 2);
+    }
+
+    auto isFinished = [&]() {
+        return isAllCorrect(best, maxBlocks) || timer.elapsed() >= timeBudgetMs || *std::max_element(spans.cbegin(), spans.cend()) < minGridSpan;
+    };
+
+    while (!isFinished()) {
+        for (size_t d = 0; d < dimensionsCount && !isFinished(); ++d) {
+            const auto& dim { dimensions[d] };
+            QVector<Variant> grid;
+            for (int k = -gridSteps; k <= gridSteps; ++k) {
+                const double value { std::clamp(best.settings.*dim.value + spans[d] * k / gridSteps, dim.min, dim.max) };
+                const bool tried { value == best.settings.*dim.value || std::any_of(grid.cbegin(), grid.cend(), [&dim, value](const Variant& v) { return v.settings.*dim.value == value; }) };
+                if (!tried) {
+                    Variant v { best.settings, 0, 0 };
+                    v.settings.*dim.value = value;
+                    grid.append(v);
+                }
+            }
+
+            QtConcurrent::blockingMap(grid, [&halfWaves, sampleRate](Variant& v) {
+                evaluate(v, halfWaves, sampleRate);
+            });
+            variants += grid.size();
+
+            for (const auto& v: grid) {
+                maxBlocks = std::max(maxBlocks, v.blocks);
+                if (isBetter(v, best)) {
+                    best = v;
+                }
+            }
+        }
+
+        for (auto& span: spans) {
+            span /= 2;
+        }
+    }
+
+    return { best.settings, best.okBlocks, best.blocks, variants };
+}
@@ -0,0 +1,44 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef PARSERSETTINGSTUNER_H
+#define PARSERSETTINGSTUNER_H
+
+#include <QVector>
+#include "sources/core/halfwavestore.h"
+#include "sources/core/parseddata.h"
+#include "sources/models/parsersettingsmodel.h"
+
+//Searches the parser settings, which give the most of the data blocks with the correct parity.
+//The deltas and the sine check tolerance are tuned one by one over the grid around the best values found so far
+//(coordinate search), the grid is narrowed after every round. All of the grid values of a setting are tried in parallel,
+//every variant is parsed from the same half-waves without the waveform marks.
+class ParserSettingsTuner final
+{
+public:
+    struct Result
+    {
+        ParserSettingsModel::ParserSettings settings;
+        int okBlocks;
+        int blocks;
+        int variants;
+    };
+
+    ParserSettingsTuner() = delete;
+
+    //Search is stopped when the time budget is exceeded, the grid can't be narrowed any more or all of the blocks are correct
+    static Result tune(const HalfWaveStore& halfWaves, const ParserSettingsModel::ParserSettings& initial, uint32_t sampleRate, qint64 timeBudgetMs);
+};
+
+#endif // PARSERSETTINGSTUNER_H
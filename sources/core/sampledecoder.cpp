@@ -0,0 +1,270 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#include "sampledecoder.h"
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define SAMPLEDECODER_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+    template <typename T>
+    __attribute__((always_inline)) inline T loadUnaligned(const uint8_t* src) {
+        T t;
+        std::memcpy(&t, src, sizeof(T));
+        return t;
+    }
+
+    //Per-format sample readers, the conversion rules are the same as were used by WavReader::getSample
+    struct Pcm8 {
+        static constexpr const size_t size = 1;
+        template <typename T> static T load(const uint8_t* src) {
+            //Scaled value of -128 is below int16 range, so it has to be saturated for the integral output
+            if constexpr (std::is_integral_v<T>) {
+                return static_cast<T>(std::clamp((*src - 128) * 258, -32768, 32767));
+            } else {
+                return static_cast<T>((*src - 128) * 258.);
+            }
+        }
+    };
+
+    struct Pcm16 {
+        static constexpr const size_t size = 2;
+        template <typename T> static T load(const uint8_t* src) {
+            return static_cast<T>(loadUnaligned<int16_t>(src));
+        }
+    };
+
+    struct Pcm24 {
+        static constexpr const size_t size = 3;
+        template <typename T> static T load(const uint8_t* src) {
+            return static_cast<T>((src[2] << 16) | (src[1] << 8) | src[0]);
+        }
+    };
+
+    struct Pcm32 {
+        static constexpr const size_t size = 4;
+        template <typename T> static T load(const uint8_t* src) {
+            return static_cast<T>(loadUnaligned<int32_t>(src));
+        }
+    };
+
+    struct Float32 {
+        static constexpr const size_t size = 4;
+        template <typename T> static T load(const uint8_t* src) {
+            return static_cast<T>(loadUnaligned<float>(src));
+        }
+    };
+
+    //Generic decode-and-deinterleave kernel, the format and the number of channels are known at compile time
+    template <typename F, typename T, unsigned Channels>
+    void decodeFrames(const uint8_t* src, size_t frames, T* ch0, T* ch1) {
+        for (size_t i = 0; i < frames; ++i) {
+            ch0[i] = F::template load<T>(src);
+            src += F::size;
+            if constexpr (Channels == 2) {
+                ch1[i] = F::template load<T>(src);
+                src += F::size;
+            }
+        }
+    }
+
+    //Mono 16-bit samples are stored as is
+    void copyPcm16(const uint8_t* src, size_t frames, int16_t* ch0, int16_t* /*ch1*/) {
+        std::memcpy(ch0, src, frames * sizeof(int16_t));
+    }
+
+#ifdef SAMPLEDECODER_X86_SIMD
+    //Each kernel processes the bulk of frames with vector instructions and returns the number of frames processed
+    template <unsigned Channels>
+    size_t decodePcm16Sse2(const uint8_t* src, size_t frames, float* ch0, float* ch1) {
+        constexpr const size_t step = 8 / Channels;
+        size_t i = 0;
+        for (; i + step <= frames; i += step, src += 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            if constexpr (Channels == 2) {
+                _mm_storeu_ps(ch0 + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(v, 16), 16)));
+                _mm_storeu_ps(ch1 + i, _mm_cvtepi32_ps(_mm_srai_epi32(v, 16)));
+            } else {
+                _mm_storeu_ps(ch0 + i, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)));
+                _mm_storeu_ps(ch0 + i + 4, _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)));
+            }
+        }
+        return i;
+    }
+
+    template <unsigned Channels>
+    __attribute__((target("avx2"))) size_t decodePcm16Avx2(const uint8_t* src, size_t frames, float* ch0, float* ch1) {
+        constexpr const size_t step = 16 / Channels;
+        size_t i = 0;
+        for (; i + step <= frames; i += step, src += 32) {
+            if constexpr (Channels == 2) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+                _mm256_storeu_ps(ch0 + i, _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_slli_epi32(v, 16), 16)));
+                _mm256_storeu_ps(ch1 + i, _mm256_cvtepi32_ps(_mm256_srai_epi32(v, 16)));
+            } else {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+                const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+                _mm256_storeu_ps(ch0 + i, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(lo)));
+                _mm256_storeu_ps(ch0 + i + 8, _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(hi)));
+            }
+        }
+        return i;
+    }
+
+    //Stereo frames are split by taking the low and the high halves of every 32-bit frame and packing them back to 16 bits
+    size_t decodePcm16Sse2(const uint8_t* src, size_t frames, int16_t* ch0, int16_t* ch1) {
+        constexpr const size_t step = 8;
+        size_t i = 0;
+        for (; i + step <= frames; i += step, src += 32) {
+            const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ch0 + i), _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(v0, 16), 16), _mm_srai_epi32(_mm_slli_epi32(v1, 16), 16)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(ch1 + i), _mm_packs_epi32(_mm_srai_epi32(v0, 16), _mm_srai_epi32(v1, 16)));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2"))) size_t decodePcm16Avx2(const uint8_t* src, size_t frames, int16_t* ch0, int16_t* ch1) {
+        constexpr const size_t step = 16;
+        size_t i = 0;
+        for (; i + step <= frames; i += step, src += 64) {
+            const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src));
+            const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 32));
+            //Packing is performed inside of 128-bit lanes, so the 64-bit parts have to be reordered afterwards
+            const __m256i l = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(v0, 16), 16), _mm256_srai_epi32(_mm256_slli_epi32(v1, 16), 16));
+            const __m256i r = _mm256_packs_epi32(_mm256_srai_epi32(v0, 16), _mm256_srai_epi32(v1, 16));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(ch0 + i), _mm256_permute4x64_epi64(l, _MM_SHUFFLE(3, 1, 2, 0)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(ch1 + i), _mm256_permute4x64_epi64(r, _MM_SHUFFLE(3, 1, 2, 0)));
+        }
+        return i;
+    }
+
+    template <unsigned Channels>
+    size_t decodeFloat32Sse2(const uint8_t* src, size_t frames, float* ch0, float* ch1) {
+        constexpr const size_t step = 4;
+        size_t i = 0;
+        for (; i + step <= frames; i += step, src += 16 * Channels) {
+            const __m128 v0 = _mm_loadu_ps(reinterpret_cast<const float*>(src));
+            if constexpr (Channels == 2) {
+                const __m128 v1 = _mm_loadu_ps(reinterpret_cast<const float*>(src + 16));
+                _mm_storeu_ps(ch0 + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+                _mm_storeu_ps(ch1 + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+            } else {
+                _mm_storeu_ps(ch0 + i, v0);
+            }
+        }
+        return i;
+    }
+
+    template <unsigned Channels>
+    __attribute__((target("avx2"))) size_t decodeFloat32Avx2(const uint8_t* src, size_t frames, float* ch0, float* ch1) {
+        constexpr const size_t step = 8;
+        size_t i = 0;
+        for (; i + step <= frames; i += step, src += 32 * Channels) {
+            const __m256 v0 = _mm256_loadu_ps(reinterpret_cast<const float*>(src));
+            if constexpr (Channels == 2) {
+                //Shuffling is performed inside of 128-bit lanes, so the 64-bit parts have to be reordered afterwards
+                const __m256 v1 = _mm256_loadu_ps(reinterpret_cast<const float*>(src + 32));
+                const __m256 l = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0));
+                const __m256 r = _mm256_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1));
+                _mm256_storeu_ps(ch0 + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(l), _MM_SHUFFLE(3, 1, 2, 0))));
+                _mm256_storeu_ps(ch1 + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(r), _MM_SHUFFLE(3, 1, 2, 0))));
+            } else {
+                _mm256_storeu_ps(ch0 + i, v0);
+            }
+        }
+        return i;
+    }
+
+    bool isAvx2Supported() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+
+    template <typename F, typename T, unsigned Channels, size_t (*Avx2Kernel)(const uint8_t*, size_t, T*, T*), size_t (*Sse2Kernel)(const uint8_t*, size_t, T*, T*)>
+    void decodeFramesSimd(const uint8_t* src, size_t frames, T* ch0, T* ch1) {
+        const size_t processed = isAvx2Supported() ? Avx2Kernel(src, frames, ch0, ch1) : Sse2Kernel(src, frames, ch0, ch1);
+        //Remaining tail is handled by the generic kernel
+        decodeFrames<F, T, Channels>(src + processed * F::size * Channels, frames - processed, ch0 + processed, Channels == 2 ? ch1 + processed : ch1);
+    }
+#endif
+
+    template <typename F, typename T>
+    struct DecoderSelector {
+        static SampleDecoder::DecodeFunction<T> get(uint16_t numberOfChannels) {
+            return numberOfChannels == 2 ? &decodeFrames<F, T, 2> : &decodeFrames<F, T, 1>;
+        }
+    };
+
+    template <>
+    struct DecoderSelector<Pcm16, int16_t> {
+        static SampleDecoder::DecodeFunction<int16_t> get(uint16_t numberOfChannels) {
+#ifdef SAMPLEDECODER_X86_SIMD
+            return numberOfChannels == 2 ? &decodeFramesSimd<Pcm16, int16_t, 2, &decodePcm16Avx2, &decodePcm16Sse2> : &copyPcm16;
+#else
+            return numberOfChannels == 2 ? &decodeFrames<Pcm16, int16_t, 2> : &copyPcm16;
+#endif
+        }
+    };
+
+#ifdef SAMPLEDECODER_X86_SIMD
+    template <>
+    struct DecoderSelector<Pcm16, float> {
+        static SampleDecoder::DecodeFunction<float> get(uint16_t numberOfChannels) {
+            return numberOfChannels == 2 ? &decodeFramesSimd<Pcm16, float, 2, &decodePcm16Avx2<2>, &decodePcm16Sse2<2>>
+                                         : &decodeFramesSimd<Pcm16, float, 1, &decodePcm16Avx2<1>, &decodePcm16Sse2<1>>;
+        }
+    };
+
+    template <>
+    struct DecoderSelector<Float32, float> {
+        static SampleDecoder::DecodeFunction<float> get(uint16_t numberOfChannels) {
+            return numberOfChannels == 2 ? &decodeFramesSimd<Float32, float, 2, &decodeFloat32Avx2<2>, &decodeFloat32Sse2<2>>
+                                         : &decodeFramesSimd<Float32, float, 1, &decodeFloat32Avx2<1>, &decodeFloat32Sse2<1>>;
+        }
+    };
+#endif
+}
+
+template <typename T>
+SampleDecoder::DecodeFunction<T> SampleDecoder::getDecodeFunction(uint16_t compressionCode, uint16_t bitsPerSample, uint16_t numberOfChannels)
+{
+    if (numberOfChannels != 1 && numberOfChannels != 2) {
+        return nullptr;
+    }
+
+    switch (bitsPerSample) {
+        case 8:
+            return DecoderSelector<Pcm8, T>::get(numberOfChannels);
+
+        case 16:
+            return DecoderSelector<Pcm16, T>::get(numberOfChannels);
+
+        case 24:
+            return DecoderSelector<Pcm24, T>::get(numberOfChannels);
+
+        case 32:
+            return compressionCode == 3 ? DecoderSelector<Float32, T>::get(numberOfChannels) : DecoderSelector<Pcm32, T>::get(numberOfChannels);
+
+        default:
+            return nullptr;
+    }
+}
+
+template SampleDecoder::DecodeFunction<float> SampleDecoder::getDecodeFunction<float>(uint16_t compressionCode, uint16_t bitsPerSample, uint16_t numberOfChannels);
+template SampleDecoder::DecodeFunction<int16_t> SampleDecoder::getDecodeFunction<int16_t>(uint16_t compressionCode, uint16_t bitsPerSample, uint16_t numberOfChannels);
@@ -0,0 +1,35 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#ifndef SAMPLEDECODER_H
+#define SAMPLEDECODER_H
+
+#include <cstddef>
+#include <cstdint>
+
+class SampleDecoder final
+{
+public:
+    //Decodes `frames` interleaved frames from `src` into the separate channel buffers.
+    //`ch1` is ignored for mono sources.
+    template <typename T>
+    using DecodeFunction = void (*)(const uint8_t* src, size_t frames, T* ch0, T* ch1);
+
+    SampleDecoder() = delete;
+
+    //Returns the decoder specialized for the given WAV format or nullptr if the format is not supported
+    template <typename T>
+    static DecodeFunction<T> getDecodeFunction(uint16_t compressionCode, uint16_t bitsPerSample, uint16_t numberOfChannels);
+};
+
+#endif // SAMPLEDECODER_H
@@ -0,0 +1,371 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#include "waveformcodec.h"
+#include <QtConcurrent>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace {
+//Disable struct alignment
+#pragma pack(push, 1)
+    struct CodedHeader
+    {
+        uint64_t samplesCount;
+        uint32_t chunkSamples;
+        uint32_t chunksCount;
+        //Followed by chunksCount + 1 offsets of the chunks relative to the end of the offsets table
+    };
+#pragma pack(pop)
+
+    constexpr const unsigned partitionSamples = 1024;
+    constexpr const unsigned riceParameterBits = 5;
+    constexpr const unsigned maxRiceParameter = 30;
+    //Residuals with the quotient of the escape length or more are stored as is
+    constexpr const unsigned escapeLength = 24;
+    constexpr const unsigned maxOrder = 3;
+    //Float samples are coded if they are integers of 24-bit range, so all of them are exactly representable
+    constexpr const float maxFloatSample = 1 << 24;
+
+    class BitWriter
+    {
+        QByteArray& m_out;
+        uint64_t m_acc;
+        unsigned m_bits;
+
+    public:
+        explicit BitWriter(QByteArray& out) : m_out(out), m_acc(0), m_bits(0) { }
+
+        //Writes up to 32 bits, MSB first
+        __attribute__((always_inline)) inline void put(uint32_t value, unsigned bits) {
+            m_acc = (m_acc << bits) | value;
+            m_bits += bits;
+            while (m_bits >= 8) {
+                m_bits -= 8;
+                m_out.append(static_cast<char>(m_acc >> m_bits));
+            }
+        }
+
+        void flush() {
+            if (m_bits > 0) {
+                m_out.append(static_cast<char>(m_acc << (8 - m_bits)));
+                m_bits = 0;
+            }
+        }
+    };
+
+    class BitReader
+    {
+        const uint8_t* m_data;
+        uint64_t m_size;
+        uint64_t m_pos;
+
+        //Returns 64 bits of the stream starting from the current bit position, MSB-aligned
+        __attribute__((always_inline)) inline uint64_t peek() const {
+            const uint64_t byte = m_pos >> 3;
+            uint64_t v;
+            if (byte + sizeof(v) <= m_size) {
+                std::memcpy(&v, m_data + byte, sizeof(v));
+                v = __builtin_bswap64(v);
+            } else {
+                v = 0;
+                for (uint64_t i = 0; i < sizeof(v); ++i) {
+                    v = (v << 8) | (byte + i < m_size ? m_data[byte + i] : 0);
+                }
+            }
+            return v << (m_pos & 7);
+        }
+
+    public:
+        BitReader(const uint8_t* data, uint64_t size) : m_data(data), m_size(size), m_pos(0) { }
+
+        __attribute__((always_inline)) inline uint32_t get(unsigned bits) {
+            if (bits == 0) {
+                return 0;
+            }
+            const uint32_t v = static_cast<uint32_t>(peek() >> (64 - bits));
+            m_pos += bits;
+            return v;
+        }
+
+        //Reads Rice-coded value with the parameter k, the value is the number of zeros before the one bit
+        //followed by k bits of the remainder or by 32 bits of the value itself after the escape
+        __attribute__((always_inline)) inline bool rice(unsigned k, uint32_t& u) {
+            //At least 57 bits are available in the window, so both the quotient and the remainder are taken at once
+            const uint64_t window = peek();
+            const unsigned q = window == 0 ? 64 : __builtin_clzll(window);
+            if (q < escapeLength) {
+                u = (q << k) | static_cast<uint32_t>(((window << (q + 1)) >> 1) >> (63 - k));
+                m_pos += q + 1 + k;
+                return true;
+            }
+
+            if (q == escapeLength) {
+                m_pos += q + 1;
+                u = get(32);
+                return true;
+            }
+
+            return false;
+        }
+
+        //Checks that no bits were taken beyond the end of data
+        bool isValid() const {
+            return m_pos <= m_size * 8;
+        }
+    };
+
+    __attribute__((always_inline)) inline uint32_t zigzag(int64_t v) {
+        return static_cast<uint32_t>((v << 1) ^ (v >> 63));
+    }
+
+    __attribute__((always_inline)) inline int64_t unzigzag(uint32_t v) {
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    //Fixed polynomial predictors, lower order is used at the beginning of the chunk
+    __attribute__((always_inline)) inline int64_t predict(unsigned order, int64_t s1, int64_t s2, int64_t s3) {
+        switch (order) {
+            case 0: return 0;
+            case 1: return s1;
+            case 2: return 2 * s1 - s2;
+            default: return 3 * s1 - 3 * s2 + s3;
+        }
+    }
+
+    template <unsigned Order>
+    __attribute__((always_inline)) inline int64_t predictFixed(int64_t s1, int64_t s2, int64_t s3) {
+        if constexpr (Order == 0) {
+            return 0;
+        } else if constexpr (Order == 1) {
+            return s1;
+        } else if constexpr (Order == 2) {
+            return 2 * s1 - s2;
+        } else {
+            return 3 * s1 - 3 * s2 + s3;
+        }
+    }
+
+    template <typename T>
+    QByteArray encodeChunk(const T* x, size_t n) {
+        //Samples of 8-bit sources are scaled, so the common divisor is taken out of them
+        int64_t divisor = 0;
+        for (size_t i = 0; i < n && divisor != 1; ++i) {
+            divisor = std::gcd(divisor, std::abs(static_cast<int64_t>(x[i])));
+        }
+        divisor = std::max<int64_t>(divisor, 1);
+
+        std::vector<int32_t> values(n);
+        std::transform(x, x + n, values.begin(), [divisor](T v) { return static_cast<int32_t>(static_cast<int64_t>(v) / divisor); });
+
+        //The order with the least sum of absolute residuals wins
+        uint64_t sums[maxOrder + 1] { };
+        for (size_t i = maxOrder; i < n; ++i) {
+            const int64_t d0 = values[i];
+            const int64_t d1 = d0 - values[i - 1];
+            const int64_t d2 = d1 - (static_cast<int64_t>(values[i - 1]) - values[i - 2]);
+            const int64_t d3 = d2 - ((static_cast<int64_t>(values[i - 1]) - values[i - 2]) - (static_cast<int64_t>(values[i - 2]) - values[i - 3]));
+            sums[0] += std::abs(d0);
+            sums[1] += std::abs(d1);
+            sums[2] += std::abs(d2);
+            sums[3] += std::abs(d3);
+        }
+        const unsigned order = std::distance(std::begin(sums), std::min_element(std::begin(sums), std::end(sums)));
+
+        QByteArray out;
+        out.reserve(static_cast<int>(n));
+        out.append(static_cast<char>(order));
+        const uint32_t storedDivisor = static_cast<uint32_t>(divisor);
+        out.append(reinterpret_cast<const char*>(&storedDivisor), sizeof(storedDivisor));
+        BitWriter writer(out);
+        uint32_t residuals[partitionSamples];
+        int64_t s1 = 0, s2 = 0, s3 = 0;
+        for (size_t p = 0; p < n; p += partitionSamples) {
+            const size_t m = std::min<size_t>(partitionSamples, n - p);
+            uint64_t sum = 0;
+            for (size_t j = 0; j < m; ++j) {
+                const size_t i = p + j;
+                const int64_t v = values[i];
+                residuals[j] = zigzag(v - predict(std::min<size_t>(order, i), s1, s2, s3));
+                sum += residuals[j];
+                s3 = s2;
+                s2 = s1;
+                s1 = v;
+            }
+
+            unsigned k = 0;
+            while (k < maxRiceParameter && (static_cast<uint64_t>(m) << k) < sum) {
+                ++k;
+            }
+            writer.put(k, riceParameterBits);
+
+            const uint32_t mask = (1u << k) - 1;
+            for (size_t j = 0; j < m; ++j) {
+                const uint32_t u = residuals[j];
+                const uint32_t q = u >> k;
+                if (q < escapeLength) {
+                    writer.put(1, q + 1);
+                    writer.put(u & mask, k);
+                } else {
+                    writer.put(1, escapeLength + 1);
+                    writer.put(u, 32);
+                }
+            }
+        }
+        writer.flush();
+
+        return out;
+    }
+
+    template <typename T, unsigned Order>
+    bool decodeResiduals(BitReader& reader, T* x, size_t n, int64_t divisor) {
+        int64_t s1 = 0, s2 = 0, s3 = 0;
+        for (size_t p = 0; p < n; p += partitionSamples) {
+            const size_t end = std::min<size_t>(p + partitionSamples, n);
+            const unsigned k = reader.get(riceParameterBits);
+            if (k > maxRiceParameter) {
+                return false;
+            }
+
+            for (size_t i = p; i < end; ++i) {
+                uint32_t u;
+                if (!reader.rice(k, u)) {
+                    return false;
+                }
+
+                const int64_t v = (i < Order ? predict(i, s1, s2, s3) : predictFixed<Order>(s1, s2, s3)) + unzigzag(u);
+                x[i] = static_cast<T>(v * divisor);
+                s3 = s2;
+                s2 = s1;
+                s1 = v;
+            }
+        }
+
+        return reader.isValid();
+    }
+
+    template <typename T>
+    bool decodeChunk(const uint8_t* data, size_t size, T* x, size_t n) {
+        uint32_t divisor;
+        if (size < 1 + sizeof(divisor)) {
+            return false;
+        }
+        std::memcpy(&divisor, data + 1, sizeof(divisor));
+        if (divisor == 0) {
+            return false;
+        }
+
+        BitReader reader(data + 1 + sizeof(divisor), size - 1 - sizeof(divisor));
+        switch (data[0]) {
+            case 0: return decodeResiduals<T, 0>(reader, x, n, divisor);
+            case 1: return decodeResiduals<T, 1>(reader, x, n, divisor);
+            case 2: return decodeResiduals<T, 2>(reader, x, n, divisor);
+            case 3: return decodeResiduals<T, 3>(reader, x, n, divisor);
+            default: return false;
+        }
+    }
+
+    template <typename T>
+    bool isCodable(const QVector<T>& samples) {
+        if constexpr (std::is_integral_v<T>) {
+            return true;
+        } else {
+            return std::all_of(samples.cbegin(), samples.cend(), [](T v) { return std::abs(v) <= maxFloatSample && std::trunc(v) == v; });
+        }
+    }
+
+    QVector<uint32_t> chunkIndexes(uint32_t chunksCount) {
+        QVector<uint32_t> indexes(chunksCount);
+        std::iota(indexes.begin(), indexes.end(), 0);
+        return indexes;
+    }
+}
+
+QByteArray WaveformCodec::encode(const QWavVector& channel)
+{
+    return channel.visit([](const auto& samples) {
+        if (!isCodable(samples)) {
+            return QByteArray();
+        }
+
+        const uint64_t samplesCount = samples.size();
+        const uint32_t chunksCount = static_cast<uint32_t>((samplesCount + chunkSamples - 1) / chunkSamples);
+        QVector<QByteArray> chunks(chunksCount);
+        QByteArray* coded = chunks.data();
+        auto indexes = chunkIndexes(chunksCount);
+        QtConcurrent::blockingMap(indexes, [&samples, coded, samplesCount](uint32_t chunk) {
+            const uint64_t begin = static_cast<uint64_t>(chunk) * chunkSamples;
+            coded[chunk] = encodeChunk(samples.constData() + begin, std::min<uint64_t>(chunkSamples, samplesCount - begin));
+        });
+
+        const CodedHeader header { samplesCount, chunkSamples, chunksCount };
+        QByteArray out(reinterpret_cast<const char*>(&header), sizeof(header));
+        uint64_t offset = 0;
+        for (const auto& c: chunks) {
+            out.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+            offset += c.size();
+        }
+        out.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        for (const auto& c: chunks) {
+            out.append(c);
+        }
+
+        return out;
+    });
+}
+
+bool WaveformCodec::decode(const uint8_t* data, uint64_t size, QWavVector& channel)
+{
+    if (size < sizeof(CodedHeader)) {
+        return false;
+    }
+
+    CodedHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    const uint64_t tableSize = (static_cast<uint64_t>(header.chunksCount) + 1) * sizeof(uint64_t);
+    if (header.chunkSamples == 0
+        || header.samplesCount > static_cast<uint64_t>(std::numeric_limits<QWavVector::size_type>::max())
+        || header.chunksCount != (header.samplesCount + header.chunkSamples - 1) / header.chunkSamples
+        || size - sizeof(CodedHeader) < tableSize) {
+        return false;
+    }
+
+    std::vector<uint64_t> offsets(header.chunksCount + 1);
+    std::memcpy(offsets.data(), data + sizeof(CodedHeader), tableSize);
+    const uint8_t* chunksData = data + sizeof(CodedHeader) + tableSize;
+    const uint64_t chunksSize = size - sizeof(CodedHeader) - tableSize;
+    for (uint32_t i = 0; i < header.chunksCount; ++i) {
+        if (offsets[i] > offsets[i + 1] || offsets[i + 1] > chunksSize) {
+            return false;
+        }
+    }
+
+    return channel.visit([&](auto& samples) {
+        samples.resize(static_cast<QWavVector::size_type>(header.samplesCount));
+        auto* x = samples.data();
+        std::atomic_bool valid { true };
+        auto indexes = chunkIndexes(header.chunksCount);
+        QtConcurrent::blockingMap(indexes, [&](uint32_t chunk) {
+            const uint64_t begin = static_cast<uint64_t>(chunk) * header.chunkSamples;
+            const uint64_t n = std::min<uint64_t>(header.chunkSamples, header.samplesCount - begin);
+            if (!decodeChunk(chunksData + offsets[chunk], offsets[chunk + 1] - offsets[chunk], x + begin, n)) {
+                valid = false;
+            }
+        });
+        return valid.load();
+    });
+}
@@ -0,0 +1,42 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#ifndef WAVEFORMCODEC_H
+#define WAVEFORMCODEC_H
+
+#include <QByteArray>
+#include "sources/core/wavvector.h"
+
+//Lossless codec of the waveform file channel sections.
+//Samples are split into independent chunks, every chunk is coded with the best of the fixed linear predictors
+//and the prediction residuals are Rice-coded, so the chunks are compressed and decompressed in parallel.
+class WaveformCodec final
+{
+public:
+    enum Codec : uint16_t {
+        NoCodec = 0,
+        PredictiveRiceCodec = 1
+    };
+
+    static constexpr const uint32_t chunkSamples = 64 * 1024;
+
+    WaveformCodec() = delete;
+
+    //Returns the coded channel or an empty array if the channel can't be coded losslessly
+    //(float samples are coded only if all of them are integer values of 24-bit range)
+    static QByteArray encode(const QWavVector& channel);
+    //Decodes data into the channel, which should be already created with the stored sample type and size
+    static bool decode(const uint8_t* data, uint64_t size, QWavVector& channel);
+};
+
+#endif // WAVEFORMCODEC_H
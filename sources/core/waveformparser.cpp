@@ -18,15 +18,292 @@
 #include <QDateTime>
 #include <QByteArray>
 #include <QVariantMap>
+#include <QThread>
+#include <QtConcurrent>
 #include <algorithm>
+#include <optional>
+#include <tuple>
+#include <vector>
+
+namespace {
+    using HalfWaves = HalfWaveStore;
+
+    //Parser state transitions from/to the rest state, used to find out where the speculative result becomes valid
+    struct RestTransition
+    {
+        uint64_t position;
+        bool rest;
+        int blocks;
+    };
+
+    //Part of the channel parsed separately, the bounds are the sample positions or the half-wave indexes depending on the source
+    struct Segment
+    {
+        size_t begin;
+        size_t end;
+        QSharedPointer<ParsedData> data;
+        std::optional<HalfWaveParser> parser;
+        std::vector<RestTransition> transitions;
+        int dropped;
+        int droppedSpans;
+        HalfWaves halfWaves;
+    };
+
+    //Channel is split into segments at zero crossings, preferably after the long half-waves of silence,
+    //and every segment is parsed in parallel as if the pilot tone is searched from its start.
+    //This speculative result is correct starting from the first half-wave after which both the speculative parser
+    //and the parser continuing the previous segment have no signal in progress, so only the part of the segment
+    //before that half-wave is parsed again sequentially. Blocks straddling the segment bounds are parsed this way too.
+    //`feed(begin, end, consumer, stop)` pushes the half-waves of the segment to the consumer until `stop` is set.
+    //Half-waves of the speculative parsing are collected into `halfWaves` unless it is null.
+    template <typename Feed>
+    void parseSegments(ParsedData& parsedData, const std::vector<size_t>& bounds, const HalfWaveClassifier& classifier, Feed feed, HalfWaves* halfWaves)
+    {
+        std::vector<Segment> segments;
+        segments.reserve(bounds.size() - 1);
+        for (size_t i { 1 }; i < bounds.size(); ++i) {
+            Segment s { bounds[i - 1], bounds[i], QSharedPointer<ParsedData>::create(), std::nullopt, { }, 0, 0, { } };
+            s.data->startPartOf(parsedData);
+            segments.push_back(std::move(s));
+        }
+
+        const bool collect { halfWaves != nullptr };
+        QtConcurrent::blockingMap(segments, [&feed, &classifier, collect](Segment& s) {
+            auto& parser { s.parser.emplace(*s.data, classifier) };
+            bool rest { true };
+            feed(s.begin, s.end, [&parser, &s, &rest, collect](const ParsedData::WaveformPart& p) {
+                if (collect) {
+                    s.halfWaves.append(p);
+                }
+                parser(p);
+                if (parser.isAtRest() != rest) {
+                    rest = !rest;
+                    s.transitions.push_back(RestTransition { p.end(), rest, s.data->getParsedData()->size() });
+                }
+            }, false);
+        });
+
+        //Stitch the segments, the parser which holds the sequential parsing state is carried over the segment bounds
+        HalfWaveParser* sequential { &*segments.front().parser };
+        std::optional<HalfWaveParser> carried;
+        for (size_t k { 1 }; k < segments.size(); ++k) {
+            auto& s { segments[k] };
+            if (sequential->isAtRest()) {
+                sequential = &*s.parser;
+                continue;
+            }
+
+            if (!carried || sequential != &*carried) {
+                carried.emplace(*sequential);
+                sequential = &*carried;
+            }
+
+            size_t transition { 0 };
+            bool speculativeRest { true };
+            int speculativeBlocks { 0 };
+            bool converged { false };
+            uint64_t convergedEnd { 0 };
+            feed(s.begin, s.end, [&](const ParsedData::WaveformPart& p) {
+                if (converged) {
+                    return;
+                }
+
+                for (; transition < s.transitions.size() && s.transitions[transition].position <= p.end(); ++transition) {
+                    speculativeRest = s.transitions[transition].rest;
+                    speculativeBlocks = s.transitions[transition].blocks;
+                }
 
-#define HARDCODED_DATA_SIGNAL_DELTA 0.75
+                (*sequential)(p);
+                converged = sequential->isAtRest() && speculativeRest;
+                convergedEnd = p.end();
+            }, converged);
+
+            //Speculative spans of the half-waves parsed again are dropped, no span crosses the convergence point as both parsers are at rest there
+            const auto& spans { *s.data->getParsedWaveform() };
+            if (converged) {
+                s.dropped = speculativeBlocks;
+                s.droppedSpans = std::distance(spans.cbegin(), ParsedData::findSpan(spans, convergedEnd + 1));
+                sequential = &*s.parser;
+            }
+            else {
+                s.dropped = s.data->getParsedData()->size();
+                s.droppedSpans = spans.size();
+            }
+        }
+        sequential->finish();
+
+        int halfWavesCount { 0 };
+        for (const auto& s: segments) {
+            parsedData.appendData(*s.data, s.dropped, s.droppedSpans);
+            halfWavesCount += s.halfWaves.size();
+        }
+
+        if (collect && segments.size() == 1) {
+            *halfWaves = std::move(segments.front().halfWaves);
+        }
+        else if (collect) {
+            halfWaves->reserve(halfWavesCount);
+            for (const auto& s: segments) {
+                halfWaves->append(s.halfWaves);
+            }
+        }
+    }
+
+    //Parses the channel samples, the half-waves found are stored to `halfWaves` unless it is null
+    template <typename T>
+    void parseSegmented(ParsedData& parsedData, const QVector<T>& ch, const HalfWaveClassifier& classifier, HalfWaves* halfWaves = nullptr)
+    {
+        const size_t minSegmentSamples { 4 * 1024 * 1024 };
+        const size_t size = ch.size();
+        const size_t segmentsCount { std::max<size_t>(1, std::min<size_t>(QThread::idealThreadCount(), size / minSegmentSamples)) };
+        const auto sampleRate { classifier.getSampleRate() };
+        //Half-wave of 10ms is much longer than the half-waves of any signal, so it is taken as silence
+        const size_t silenceLength { std::max<uint32_t>(1, sampleRate / 100) };
+        const size_t silenceSearchLength { static_cast<size_t>(sampleRate) * 5 };
+
+        std::vector<size_t> bounds { 0 };
+        for (size_t i { 1 }; i < segmentsCount; ++i) {
+            //Look for the end of the long half-wave nearby, otherwise split at the first zero crossing
+            const size_t from { std::max(bounds.back() + 1, size / segmentsCount * i) };
+            const size_t limit { std::min(size, from + silenceSearchLength) };
+            size_t crossing { 0 };
+            size_t runBegin { from - 1 };
+            for (size_t j { from }; j < limit; ++j) {
+                if (lessThanZero(ch[j]) != lessThanZero(ch[j - 1])) {
+                    const bool silence { j - runBegin >= silenceLength };
+                    if (crossing == 0 || silence) {
+                        crossing = j;
+                    }
+                    if (silence) {
+                        break;
+                    }
+                    runBegin = j;
+                }
+            }
+            if (crossing != 0) {
+                bounds.push_back(crossing);
+            }
+        }
+        bounds.push_back(size);
+
+        parseSegments(parsedData, bounds, classifier, [&ch](size_t begin, size_t end, auto&& consumer, const bool& stop) {
+            HalfWaveScanner<decltype(consumer)&> scanner(consumer, begin);
+            const size_t windowSize { 64 * 1024 };
+            for (size_t pos { begin }; pos < end && !stop; pos += windowSize) {
+                scanner.feed(ch.constData() + pos, std::min(windowSize, end - pos));
+            }
+            if (!stop) {
+                scanner.finish();
+            }
+        }, halfWaves);
+    }
+
+    //Parses the half-waves found by the previous parsing of the same channel samples, so the zero crossings aren't detected again
+    void parseHalfWaves(ParsedData& parsedData, const HalfWaves& halfWaves, const HalfWaveClassifier& classifier)
+    {
+        const size_t minSegmentHalfWaves { 256 * 1024 };
+        const size_t size = halfWaves.size();
+        const size_t segmentsCount { std::max<size_t>(1, std::min<size_t>(QThread::idealThreadCount(), size / minSegmentHalfWaves)) };
+        const auto sampleRate { classifier.getSampleRate() };
+        const uint32_t silenceLength { std::max<uint32_t>(1, sampleRate / 100) };
+        const uint64_t silenceSearchLength { static_cast<uint64_t>(sampleRate) * 5 };
+
+        std::vector<size_t> bounds { 0 };
+        for (size_t i { 1 }; i < segmentsCount; ++i) {
+            //Split after the long half-wave nearby, otherwise at the first half-wave of the segment
+            const size_t from { std::max(bounds.back() + 1, size / segmentsCount * i) };
+            if (from >= size) {
+                break;
+            }
+            size_t split { from };
+            const auto searchEnd { halfWaves[from].begin + silenceSearchLength };
+            for (auto it { halfWaves.cbegin() + static_cast<int>(from - 1) }; it.index() + 1 < static_cast<int>(size) && it->begin + it->length < searchEnd; ++it) {
+                if (it->length >= silenceLength) {
+                    split = it.index() + 1;
+                    break;
+                }
+            }
+            bounds.push_back(split);
+        }
+        bounds.push_back(size);
+
+        parseSegments(parsedData, bounds, classifier, [&halfWaves](size_t begin, size_t end, auto&& consumer, const bool& stop) {
+            for (auto it { halfWaves.cbegin() + static_cast<int>(begin) }; it.index() < static_cast<int>(end) && !stop; ++it) {
+                consumer(*it);
+            }
+        }, nullptr);
+    }
+
+    //Parses again the part of the channel affected by the samples edited in place and patches the parsed data.
+    //The parser is at rest right after every data block, so parsing is restarted after the last block which ends before the edited samples.
+    //It stops at the end of the first following block of the previous result, if the parser is at rest there as well,
+    //because the zero crossings after the edited samples are intact and the rest of the channel is parsed the same way then.
+    //Returns the range of samples parsed again.
+    template <typename T>
+    std::pair<uint64_t, uint64_t> parseEdited(ParsedData& parsedData, const QVector<T>& ch, uint64_t editBegin, uint64_t editEnd, const HalfWaveClassifier& classifier)
+    {
+        const auto& blocks { *parsedData.getParsedData() };
+        const uint64_t size = ch.size();
+
+        //Restart position is the zero crossing, which depends on the preceding sample too, so it should be before the edited samples
+        int first { 0 };
+        while (first < blocks.size() && blocks[first].dataEnd + 1 < editBegin) {
+            ++first;
+        }
+        const uint64_t begin { first == 0 ? 0 : blocks[first - 1].dataEnd + 1 };
+
+        ParsedData edited;
+        edited.startPartOf(parsedData);
+        HalfWaveParser parser(edited, classifier);
+        int next { first };
+        uint64_t end { size };
+        bool converged { false };
+        HalfWaveScanner scanner([&](const ParsedData::WaveformPart& p) {
+            if (converged) {
+                return;
+            }
+
+            parser(p);
+
+            const auto e { p.end() };
+            while (next < blocks.size() && (blocks[next].dataEnd < e || blocks[next].dataEnd <= editEnd)) {
+                ++next;
+            }
+            if (next < blocks.size() && blocks[next].dataEnd == e && parser.isAtRest()) {
+                converged = true;
+                end = e + 1;
+            }
+        }, begin);
+
+        const size_t windowSize { 64 * 1024 };
+        for (size_t pos = begin; pos < size && !converged; pos += windowSize) {
+            scanner.feed(ch.constData() + pos, std::min<size_t>(windowSize, size - pos));
+        }
+        if (!converged) {
+            scanner.finish();
+            parser.finish();
+        }
+
+        parsedData.replaceData(first, (converged ? next + 1 : blocks.size()) - first, edited);
+        //Neither of the parsings has a signal in progress at the bounds of the range, so no span crosses them
+        parsedData.replaceSpans(begin, end, edited);
+        return { begin, end };
+    }
+}
 
 WaveformParser::WaveformParser(QObject* parent) :
     QObject(parent),
-    mWavReader(*WavReader::instance())
+    mWavReader(*WavReader::instance()),
+    m_autoTuneWatcher(nullptr),
+    m_bitRepairWatcher(nullptr),
+    m_bitRepairsChannel(0),
+    m_bitRepairsValid(true),
+    m_parsedBlocksModels { new ParsedBlocksModel(this), new ParsedBlocksModel(this) }
 {
-
+    //Classifier is dropped on any settings change and built again by the next parsing
+    connect(ParserSettingsModel::instance(), &ParserSettingsModel::parserSettingsChanged, this, [this]() {
+        m_classifier.reset();
+    });
 }
 
 void WaveformParser::repairWaveform2(uint chNum) {
@@ -35,33 +312,33 @@ void WaveformParser::repairWaveform2(uint chNum) {
         return;
     }
 
-    QWavVector& channel = *(chNum == 0 ? mWavReader.getChannel0() : mWavReader.getChannel1());
-    QVector<ParsedData::WaveformPart> parsed = parseChannel<QWavVectorType>(channel);
-
-    const auto& parserSettings = ParserSettingsModel::instance()->getParserSettings();
-    const double sampleRate = mWavReader.getSampleRate();
-    for (auto it { parsed.begin() }; it != parsed.end();) {
-        auto itprev = it++;
-        if (it != parsed.end()) {
-            bool isZero = isZeroFreqFitsInDelta(sampleRate, (*it).length + (*itprev).length, parserSettings.zeroFreq, parserSettings.zeroDelta, HARDCODED_DATA_SIGNAL_DELTA);
-            bool isOne = isOneFreqFitsInDelta(sampleRate, (*it).length + (*itprev).length, parserSettings.oneFreq, HARDCODED_DATA_SIGNAL_DELTA, parserSettings.oneDelta);
-            if (isZero || isOne) {
-                auto it1 = std::next(channel.begin(), (*itprev).begin);
-                auto it2 = std::next(channel.begin(), (*it).end);
-                auto itmiddle = std::next(it1, std::distance(it1, it2) / 2);
-                const auto min_max = std::minmax_element(it1, it2);
-                auto [val1, val2] = (*itprev).sign == ParsedData::WaveformSign::NEGATIVE ? min_max : decltype(min_max) {min_max.second, min_max.first};
-                auto itr = it1;
-                for (; itr != itmiddle; ++itr) {
-                    *itr  = *val1;
-                }
-                for (; itr != it2; ++itr) {
-                    *itr = *val2;
+    QWavVector& wavChannel = *(chNum == 0 ? mWavReader.getChannel0() : mWavReader.getChannel1());
+    wavChannel.visit([&](auto& channel) {
+        const HalfWaveStore parsed = parseChannel(channel);
+
+        const auto classifier { getClassifier() };
+        for (auto it { parsed.cbegin() }; it != parsed.cend();) {
+            auto itprev = it++;
+            if (it != parsed.cend()) {
+                if (classifier->is((*it).length + (*itprev).length, HalfWaveClassifier::zeroBit | HalfWaveClassifier::oneBit)) {
+                    auto it1 = std::next(channel.begin(), (*itprev).begin);
+                    auto it2 = std::next(channel.begin(), (*it).end());
+                    auto itmiddle = std::next(it1, std::distance(it1, it2) / 2);
+                    const auto min_max = std::minmax_element(it1, it2);
+                    auto [val1, val2] = (*itprev).sign == ParsedData::WaveformSign::NEGATIVE ? min_max : decltype(min_max) {min_max.second, min_max.first};
+                    auto itr = it1;
+                    for (; itr != itmiddle; ++itr) {
+                        *itr  = *val1;
+                    }
+                    for (; itr != it2; ++itr) {
+                        *itr = *val2;
+                    }
                 }
+                ++it;
             }
-            ++it;
         }
-    }
+    });
+    markChanged(chNum);
 }
 
 inline ParsedData* WaveformParser::getOrCreateParsedDataPtr(uint chNum)
@@ -80,255 +357,363 @@ inline ParsedData* WaveformParser::getParsedDataPtr(uint chNum) const
     return *parsedDataIt;
 }
 
-QSharedPointer<QVector<ParsedData::DataBlock>> WaveformParser::getParsedDataSharedPtr(uint chNum) const
+ParsedData::SnapshotPtr WaveformParser::getSnapshot(uint chNum) const
 {
-    auto p = getParsedDataPtr(chNum);
-    return p == nullptr ? QSharedPointer<QVector<ParsedData::DataBlock>> { } : p->getParsedData();
-}
+    static const ParsedData::SnapshotPtr empty { ParsedData::SnapshotPtr::create() };
 
-inline bool WaveformParser::isZeroFreqFitsInDelta(uint32_t sampleRate, uint32_t length, uint32_t signalFreq, double signalDeltaBelow, double signalDeltaAbove) const
-{
-    return isFreqFitsInDelta2(sampleRate, length, signalFreq, signalDeltaBelow, signalDeltaAbove);
+    QMutexLocker locker(&m_snapshotsMutex);
+    return m_snapshots.value(chNum, empty);
 }
 
-inline bool WaveformParser::isOneFreqFitsInDelta(uint32_t sampleRate, uint32_t length, uint32_t signalFreq, double signalDeltaBelow, double signalDeltaAbove) const
+QSharedPointer<const HalfWaveClassifier> WaveformParser::getClassifier()
 {
-    return isFreqFitsInDelta2(sampleRate, length, signalFreq, signalDeltaBelow, signalDeltaAbove);
+    const auto sampleRate { mWavReader.getSampleRate() };
+    if (m_classifier.isNull() || m_classifier->getSampleRate() != sampleRate) {
+        m_classifier = QSharedPointer<const HalfWaveClassifier>::create(ParserSettingsModel::instance()->getParserSettings(), sampleRate);
+    }
+    return m_classifier;
 }
 
-void WaveformParser::parse(uint chNum)
+QVector<uint> WaveformParser::parseChannels(const QVector<uint>& channels)
 {
-    if (chNum >= mWavReader.getNumberOfChannels()) {
-        qDebug() << "Trying to parse channel that exceeds overall number of channels";
-        return;
-    }
+    struct ChannelParsing
+    {
+        uint chNum;
+        QSharedPointer<QWavVector> channel;
+        ParsedData* parsedData;
+        bool incremental;
+        uint64_t editBegin;
+        uint64_t editEnd;
+        QSharedPointer<const HalfWaves> cachedHalfWaves;
+        QSharedPointer<HalfWaves> foundHalfWaves;
+    };
+
+    const auto classifier { getClassifier() };
+    const auto& settings { classifier->getSettings() };
 
-    QWavVector& channel = *(chNum == 0 ? mWavReader.getChannel0() : mWavReader.getChannel1());
-    QVector<ParsedData::WaveformPart> parsed = parseChannel<QWavVectorType>(channel);
-
-    const double sampleRate = mWavReader.getSampleRate();
-    auto& parsedData = *getOrCreateParsedDataPtr(chNum);
-    parsedData.clear(channel.size());
-
-    auto currentState = SEARCH_OF_PILOT_TONE;
-    auto it = parsed.begin();
-    QVector<uint8_t> data;
-    QVector<ParsedData::WaveformPart> waveformData;
-    QMap<size_t, uint> data_mapping;
-    //WaveformSign signalDirection = POSITIVE;
-    uint32_t dataStart = 0;
-    uint8_t bitIndex = 0;
-    uint8_t bit = 0;
-    uint8_t parity = 0;
-
-    const auto& parserSettings = ParserSettingsModel::instance()->getParserSettings();
-    auto isSineNormal = [&parserSettings, sampleRate](const ParsedData::WaveformPart& b, const ParsedData::WaveformPart& e, bool zeroCheck) -> bool {
-        if (parserSettings.checkForAbnormalSine) {
-            return isFreqFitsInDelta(sampleRate, b.length, zeroCheck ? parserSettings.zeroHalfFreq : parserSettings.oneHalfFreq, zeroCheck ? parserSettings.zeroDelta : parserSettings.oneDelta, parserSettings.sineCheckTolerance) &&
-                   isFreqFitsInDelta(sampleRate, e.length, zeroCheck ? parserSettings.zeroHalfFreq : parserSettings.oneHalfFreq, zeroCheck ? parserSettings.zeroDelta : parserSettings.oneDelta, parserSettings.sineCheckTolerance);
+    //Parsed data objects are owned by the parser, so they are created in its thread before the parsing is started
+    QVector<ChannelParsing> parsing;
+    for (auto chNum: channels) {
+        if (chNum >= mWavReader.getNumberOfChannels()) {
+            qDebug() << "Trying to parse channel that exceeds overall number of channels";
+            continue;
         }
-        return true;
-    };
 
-    const auto isPilotHalfFreq = [&parserSettings, sampleRate](const ParsedData::WaveformPart& p) -> bool {
-        return isFreqFitsInDelta(sampleRate, p.length, parserSettings.pilotHalfFreq, parserSettings.pilotDelta, 1.0);
-    };
-    const auto isSynchroFirstHalfFreq = [&parserSettings, sampleRate](const ParsedData::WaveformPart& p, double deltaDivider = 1.0) -> bool {
-        return isFreqFitsInDelta(sampleRate, p.length, parserSettings.synchroFirstHalfFreq, parserSettings.synchroDelta, deltaDivider);
-    };
-    const auto isSynchroSecondHalfFreq = [&parserSettings, sampleRate](const ParsedData::WaveformPart& p, double deltaDivider = 1.0) -> bool {
-        return isFreqFitsInDelta(sampleRate, p.length, parserSettings.synchroSecondHalfFreq, parserSettings.synchroDelta, deltaDivider);
-    };
+        const auto channelPtr { chNum == 0 ? mWavReader.getChannel0() : mWavReader.getChannel1() };
+        if (channelPtr.isNull()) {
+            qDebug() << "Trying to parse channel that has no data loaded";
+            continue;
+        }
 
-    while (currentState != NO_MORE_DATA) {
-        auto prevIt = it;
-        switch (currentState) {
-        case SEARCH_OF_PILOT_TONE:
-            it = std::find_if(it, parsed.end(), [&isPilotHalfFreq, &parsedData, this](const ParsedData::WaveformPart& p) {
-                parsedData.fillParsedWaveform(p, 0);
-                return isPilotHalfFreq(p);
-            });
-            if (it != parsed.end()) {
-                currentState = PILOT_TONE;
+        //Only the edited part is parsed again if nothing else is changed since the channel was parsed
+        const auto state { m_parsedChannelStates.constFind(chNum) };
+        const bool incremental { state != m_parsedChannelStates.cend() && state->edited && state->channel == channelPtr &&
+                                 state->size == channelPtr->size() && state->settings == settings && m_parsedData.contains(chNum) };
+        auto parsedData = getOrCreateParsedDataPtr(chNum);
+        ChannelParsing p { chNum, channelPtr, parsedData, incremental, incremental ? state->editBegin : 0, incremental ? state->editEnd : 0, { }, { } };
+        if (!incremental) {
+            parsedData->clear(true);
+            //Otherwise the half-waves are taken from the cache if the channel content is the same, or found again and cached
+            p.cachedHalfWaves = getCachedHalfWaves(chNum, channelPtr);
+            if (p.cachedHalfWaves.isNull()) {
+                p.foundHalfWaves = QSharedPointer<HalfWaves>::create();
             }
-            break;
-
-        case PILOT_TONE:
-            for (; it != parsed.end() && isPilotHalfFreq(*it); ++it) {
-                //Mark parsed waveform as pilot-tone
-                parsedData.fillParsedWaveform(*it, ParsedData::pilotTone | ParsedData::sequenceMiddle);
-            };
-
-            //Found the first half of SYNCHRO signal
-            if (it != parsed.end()) {
-                if (auto itnext { std::next(it) };
-                    (parserSettings.preciseSynchroCheck && isSynchroFirstHalfFreq(*it)) ||
-                    (!parserSettings.preciseSynchroCheck &&
-                     (itnext != parsed.end() &&
-                      isFreqFitsInDelta(sampleRate, it->length + itnext->length, parserSettings.synchroFreq, parserSettings.synchroDelta, 1.0))))
-                {
-                    auto eIt = std::prev(it);
-                    //Mark parsed waveform as pilot-tone and sets the begin and end bounds
-                    parsedData.fillParsedWaveform(*eIt, ParsedData::pilotTone | ParsedData::sequenceMiddle,
-                                                  prevIt->begin, ParsedData::pilotTone | ParsedData::sequenceBegin,
-                                                  eIt->end, ParsedData::pilotTone | ParsedData::sequenceEnd);
-                    currentState = SYNCHRO_SIGNAL;
-                }
-                else {
-                    currentState = SEARCH_OF_PILOT_TONE;
-                }
+        }
+        parsing.append(p);
+    }
+
+    //Every channel is parsed into its own parsed data, so channels don't share anything but the read-only classifier
+    QtConcurrent::blockingMap(parsing, [&classifier](ChannelParsing& p) {
+        p.channel->visit([&p, &classifier](const auto& ch) {
+            if (p.incremental) {
+                std::tie(p.editBegin, p.editEnd) = parseEdited(*p.parsedData, ch, p.editBegin, p.editEnd, *classifier);
             }
-            else {
-                currentState = SEARCH_OF_PILOT_TONE;
+            else if (p.cachedHalfWaves) {
+                parseHalfWaves(*p.parsedData, *p.cachedHalfWaves, *classifier);
             }
-            break;
-
-        case SYNCHRO_SIGNAL:
-            it = std::next(it);
-            if (it != parsed.end()) {
-                //Check for second half of SYNCHRO signal or if `preciseSynchroCheck` option is off - assume there is synchro, because we did the check on the previous step
-                if (!parserSettings.preciseSynchroCheck || isSynchroSecondHalfFreq(*it)) {
-                    //Mark parsed waveform as syncro signal and sets the begin and end bounds
-                    parsedData.fillParsedWaveform(*prevIt, *it, ParsedData::synchroSignal | ParsedData::sequenceMiddle,
-                                                  ParsedData::synchroSignal | ParsedData::sequenceBegin,
-                                                  ParsedData::synchroSignal | ParsedData::sequenceEnd);
-
-                    //Initializing the currently parsing data block
-                    currentState = DATA_SIGNAL;
-
-                    it = std::next(it);
-                    dataStart = std::distance(parsed.begin(), it);
-                    data.clear();
-                    waveformData.clear();
-                    data_mapping.clear();
-                    bitIndex ^= bitIndex;
-                    bit ^= bit;
-                }
-                else {
-                    //Got the synchro error
-                    currentState = SEARCH_OF_PILOT_TONE;
-                }
+            else {
+                parseSegmented(*p.parsedData, ch, *classifier, p.foundHalfWaves.get());
             }
-            break;
-
-        case DATA_SIGNAL:
-            it = std::next(it);
-            if (it != parsed.end()) {
-                const auto len = it->length + prevIt->length;
-                const auto storeParsedByte = [&parsedData, &bitIndex, &data, &waveformData, &parity, &bit, it]() {
-                    //Store parsed byte in data buffer
-                    bitIndex ^= bitIndex;
-                    data.append(bit);
-                    waveformData.append(*it);
-                    parity ^= bit;
-                    bit ^= bit;
-                };
-
-                //"0" - ZERO
-                if (isZeroFreqFitsInDelta(sampleRate, len, parserSettings.zeroFreq, parserSettings.zeroDelta, HARDCODED_DATA_SIGNAL_DELTA) && isSineNormal(*prevIt, *it, true)) {
-                    //Mark parsed waveform as "0"-bit and sets the begin and end bounds
-                    parsedData.fillParsedWaveform(*prevIt, *it, ParsedData::zeroBit | ParsedData::sequenceMiddle,
-                                                  ParsedData::zeroBit | ParsedData::sequenceBegin | (bitIndex == 0 ? ParsedData::byteBound : 0),
-                                                  ParsedData::zeroBit | ParsedData::sequenceEnd | (bitIndex == 7 ? ParsedData::byteBound : 0));
-
-                    if (bitIndex == 0) {
-                        data_mapping.insert((*prevIt).begin, data.size());
-                    }
+        });
+    });
+
+    QVector<uint> result;
+    for (const auto& p: parsing) {
+        result.append(p.chNum);
+        if (!p.incremental && p.cachedHalfWaves.isNull()) {
+            p.foundHalfWaves->squeeze();
+            m_halfWaveCaches.insert(p.chNum, { p.channel, m_channelVersions.value(p.chNum), p.foundHalfWaves });
+        }
+        m_parsedChannelStates.insert(p.chNum, { p.channel, p.channel->size(), settings, false, 0, 0 });
+    }
 
-                    if (bitIndex++ == 7) {
-                        data_mapping.insert((*it).end, data.size());
-                        storeParsedByte();
-                        // //Update byte bound mark
-                        // parsedData.orParsedWaveform(it->end, ParsedData::byteBound);
-                        // //Store parsed byte in data buffer
-                        // bitIndex ^= bitIndex;
-                        // data.append(bit);
-                        // waveformData.append(*it);
-                        // parity ^= bit;
-                        // bit ^= bit;
-                    }
-                }
-                // "1" - ONE
-                else if (isOneFreqFitsInDelta(sampleRate, len, parserSettings.oneFreq, HARDCODED_DATA_SIGNAL_DELTA, parserSettings.oneDelta) && isSineNormal(*prevIt, *it, false)) {
-                    //Mark parsed waveform as "1"-bit and sets the begin and end bounds
-                    parsedData.fillParsedWaveform(*prevIt, *it, ParsedData::oneBit | ParsedData::sequenceMiddle,
-                                                  ParsedData::oneBit | ParsedData::sequenceBegin | (bitIndex == 0 ? ParsedData::byteBound : 0),
-                                                  ParsedData::oneBit | ParsedData::sequenceEnd | (bitIndex == 7 ? ParsedData::byteBound : 0));
-
-                    if (bitIndex == 0) {
-                        data_mapping.insert((*prevIt).begin, data.size());
-                    }
+    return result;
+}
 
-                    //Set the currently parsed bit
-                    bit |= 1 << (7 - bitIndex);
-                    if (bitIndex++ == 7) {
-                        data_mapping.insert((*it).end, data.size());
-                        storeParsedByte();
-                        // //Update byte bound mark
-                        // parsedData.orParsedWaveform(it->end, ParsedData::byteBound);
-                        // //Store parsed byte in data buffer
-                        // bitIndex ^= bitIndex;
-                        // data.append(bit);
-                        // waveformData.append(*it);
-                        // parity ^= bit;
-                        // bit ^= bit;
-                    }
-                }
-                else {
-                    currentState = END_OF_DATA;
-                    if (!data.empty()) {
-                        parity ^= data.last(); //Removing parity byte from overal parity check sum
-                        //Storing parsed data
-                        parsedData.storeData(std::move(data), std::move(data_mapping), parsed.at(dataStart).begin, parsed.at(std::distance(parsed.begin(), it)).end, std::move(waveformData), parity);
-                        parity ^= parity; //Zeroing parity byte
-                    }
-                }
-                it = std::next(it);
-            }
-            else if (!data.empty()) {
-                parity ^= data.last(); //Remove parity byte from overal parity check sum
-                //Storing parsed data
-                parsedData.storeData(std::move(data), std::move(data_mapping), parsed.at(dataStart).begin, parsed.at(parsed.size() - 1).end, std::move(waveformData), parity);
-                parity ^= parity; //Zeroing parity byte
-            }
-            break;
+QSharedPointer<const HalfWaveStore> WaveformParser::getCachedHalfWaves(uint chNum, const QSharedPointer<QWavVector>& channel) const
+{
+    const auto cache { m_halfWaveCaches.constFind(chNum) };
+    if (cache != m_halfWaveCaches.cend() && cache->channel == channel && cache->version == m_channelVersions.value(chNum)) {
+        return cache->halfWaves;
+    }
+    return { };
+}
 
-        case END_OF_DATA:
-            currentState = SEARCH_OF_PILOT_TONE;
-            break;
+QSharedPointer<const HalfWaveStore> WaveformParser::getHalfWaves(uint chNum)
+{
+    if (chNum >= mWavReader.getNumberOfChannels()) {
+        qDebug() << "Trying to get half-waves of channel that exceeds overall number of channels";
+        return { };
+    }
 
-        default:
-            break;
-        }
+    const auto channelPtr { chNum == 0 ? mWavReader.getChannel0() : mWavReader.getChannel1() };
+    if (channelPtr.isNull()) {
+        qDebug() << "Trying to get half-waves of channel that has no data loaded";
+        return { };
+    }
+
+    auto halfWaves { getCachedHalfWaves(chNum, channelPtr) };
+    if (halfWaves.isNull()) {
+        halfWaves = QSharedPointer<const HalfWaveStore>::create(channelPtr->visit([this](const auto& ch) { return parseChannel(ch); }));
+        m_halfWaveCaches.insert(chNum, { channelPtr, m_channelVersions.value(chNum), halfWaves });
+    }
+    return halfWaves;
+}
 
-        if (it == parsed.end()) {
-            currentState = NO_MORE_DATA;
+void WaveformParser::autoTuneSettings(uint chNum, int timeBudgetMs)
+{
+    if (m_autoTuneWatcher) {
+        qDebug() << "Parser settings are already being tuned";
+        return;
+    }
+
+    const auto halfWaves { getHalfWaves(chNum) };
+    if (halfWaves.isNull()) {
+        return;
+    }
+
+    const auto settings { ParserSettingsModel::instance()->getParserSettings() };
+    const auto sampleRate { mWavReader.getSampleRate() };
+    m_autoTuneWatcher = new QFutureWatcher<ParserSettingsTuner::Result>(this);
+    connect(m_autoTuneWatcher, &QFutureWatcher<ParserSettingsTuner::Result>::finished, this, [this]() {
+        const auto result { m_autoTuneWatcher->result() };
+        m_autoTuneWatcher->deleteLater();
+        m_autoTuneWatcher = nullptr;
+
+        //Only the tuned settings are applied, so the settings changed during the tuning are kept
+        auto& model { *ParserSettingsModel::instance() };
+        model.setPilotDelta(result.settings.pilotDelta);
+        model.setSynchroDelta(result.settings.synchroDelta);
+        model.setZeroDelta(result.settings.zeroDelta);
+        model.setOneDelta(result.settings.oneDelta);
+        model.setSineCheckTolerance(result.settings.sineCheckTolerance);
+
+        emit autoTuningChanged();
+        emit settingsAutoTuned(result.okBlocks, result.blocks);
+    });
+    m_autoTuneWatcher->setFuture(QtConcurrent::run([halfWaves, settings, sampleRate, timeBudgetMs]() {
+        return ParserSettingsTuner::tune(*halfWaves, settings, sampleRate, timeBudgetMs);
+    }));
+
+    emit autoTuningChanged();
+}
+
+void WaveformParser::searchBitRepairs(uint chNum, uint blockNum, int timeBudgetMs)
+{
+    if (m_bitRepairWatcher) {
+        qDebug() << "Bit repairs are already being searched";
+        return;
+    }
+
+    const auto snapshot { getSnapshot(chNum) };
+    const auto& parsedData { snapshot->blocks };
+    if (blockNum >= (unsigned) parsedData.size()) {
+        qDebug() << "Trying to search bit repairs of block that exceeds overall number of blocks";
+        return;
+    }
+
+    const auto halfWaves { getHalfWaves(chNum) };
+    if (halfWaves.isNull()) {
+        return;
+    }
+
+    m_bitRepairs.clear();
+    m_bitRepairsValid = true;
+    emit bitRepairsChanged();
+
+    const auto block { parsedData.at(blockNum) };
+    const auto classifier { getClassifier() };
+    const auto version { m_channelVersions.value(chNum) };
+    m_bitRepairWatcher = new QFutureWatcher<BitRepairSolver::Result>(this);
+    connect(m_bitRepairWatcher, &QFutureWatcher<BitRepairSolver::Result>::finished, this, [this, chNum, version]() {
+        const auto result { m_bitRepairWatcher->result() };
+        m_bitRepairWatcher->deleteLater();
+        m_bitRepairWatcher = nullptr;
+
+        //Repairs found for the previous channel content would damage the waveform
+        if (m_channelVersions.value(chNum) == version) {
+            m_bitRepairsChannel = chNum;
+            m_bitRepairs = result.candidates;
+            m_bitRepairsValid = result.valid;
+        }
+        else {
+            qDebug() << "Channel is changed while bit repairs are being searched, repairs are dropped";
         }
+
+        emit searchingBitRepairsChanged();
+        emit bitRepairsChanged();
+    });
+    m_bitRepairWatcher->setFuture(QtConcurrent::run([block, halfWaves, classifier, timeBudgetMs]() {
+        return BitRepairSolver::solve(block, *halfWaves, *classifier, timeBudgetMs);
+    }));
+
+    emit searchingBitRepairsChanged();
+}
+
+void WaveformParser::clearBitRepairs(uint chNum)
+{
+    if (m_bitRepairsChannel == chNum && !m_bitRepairs.isEmpty()) {
+        m_bitRepairs.clear();
+        emit bitRepairsChanged();
     }
+}
 
-    if (chNum == 0) {
-        emit parsedChannel0Changed();
+std::optional<BitRepairSolver::Candidate> WaveformParser::getBitRepair(int index) const
+{
+    if (index < 0 || index >= m_bitRepairs.size()) {
+        return std::nullopt;
+    }
+    return m_bitRepairs[index];
+}
+
+uint WaveformParser::getBitRepairsChannel() const
+{
+    return m_bitRepairsChannel;
+}
+
+void WaveformParser::markEdited(uint chNum, uint64_t begin, uint64_t end)
+{
+    ++m_channelVersions[chNum];
+    clearBitRepairs(chNum);
+    auto state { m_parsedChannelStates.find(chNum) };
+    if (state == m_parsedChannelStates.end()) {
+        return;
+    }
+
+    if (state->edited) {
+        state->editBegin = std::min(state->editBegin, begin);
+        state->editEnd = std::max(state->editEnd, end);
     }
     else {
-        emit parsedChannel1Changed();
+        state->edited = true;
+        state->editBegin = begin;
+        state->editEnd = end;
     }
 }
 
-void WaveformParser::saveTap(uint chNum, const QString& fileName)
+void WaveformParser::markChanged(uint chNum)
+{
+    ++m_channelVersions[chNum];
+    clearBitRepairs(chNum);
+    m_parsedChannelStates.remove(chNum);
+}
+
+void WaveformParser::parse(uint chNum)
+{
+    for (auto ch: parseChannels({ chNum })) {
+        notifyParsedChannelChanged(ch);
+    }
+}
+
+void WaveformParser::parseAll()
+{
+    QVector<uint> channels;
+    for (uint ch = 0; ch < mWavReader.getNumberOfChannels(); ++ch) {
+        channels.append(ch);
+    }
+
+    //Results are published only after all of the channels are parsed, so QML never sees a half-parsed stereo pair
+    for (auto ch: parseChannels(channels)) {
+        notifyParsedChannelChanged(ch);
+    }
+}
+
+WavReader::ErrorCodesEnum WaveformParser::parseStreamed(size_t windowFrames)
+{
+    const auto numberOfChannels { mWavReader.getNumberOfChannels() };
+    const auto classifier { getClassifier() };
+    std::vector<HalfWaveParser> parsers;
+    std::vector<HalfWaveScanner<HalfWaveParser&>> scanners;
+    parsers.reserve(numberOfChannels);
+    scanners.reserve(numberOfChannels);
+    for (uint chNum = 0; chNum < numberOfChannels; ++chNum) {
+        auto& parsedData = *getOrCreateParsedDataPtr(chNum);
+        parsedData.clear(true);
+        parsers.emplace_back(parsedData, *classifier);
+        scanners.emplace_back(parsers.back());
+    }
+
+    //Samples of every window are dropped right after the zero-crossing detection and the half-waves are parsed on the fly
+    const auto result = mWavReader.readStreamed([&scanners](const QWavVector& ch0, const QWavVector& ch1, size_t frames) {
+        for (size_t i = 0; i < scanners.size(); ++i) {
+            (i == 0 ? ch0 : ch1).visit([&scanner = scanners[i], frames](const auto& samples) {
+                scanner.feed(samples.constData(), frames);
+            });
+        }
+        return true;
+    }, windowFrames);
+
+    if (result != WavReader::Ok) {
+        qDebug() << "Unable to stream WAV data: " << result;
+    }
+
+    //The channels are parsed up to the last streamed window even if streaming failed
+    for (uint chNum = 0; chNum < numberOfChannels; ++chNum) {
+        scanners[chNum].finish();
+        parsers[chNum].finish();
+        notifyParsedChannelChanged(chNum);
+    }
+    return result;
+}
+
+void WaveformParser::notifyParsedChannelChanged(uint chNum)
 {
     auto parsedDataPtr { getParsedDataPtr(chNum) };
     if (parsedDataPtr == nullptr) {
         return;
     }
 
+    //The whole result is swapped at once, so the readers see either the previous parsing or this one
+    const auto snapshot { parsedDataPtr->makeSnapshot() };
+    {
+        QMutexLocker locker(&m_snapshotsMutex);
+        m_snapshots.insert(chNum, snapshot);
+    }
+
+    auto model { getParsedBlocksModel(chNum) };
+    if (model != nullptr) {
+        model->setBlocks(snapshot);
+    }
+}
+
+bool WaveformParser::saveTap(uint chNum, const QString& fileName)
+{
+    const auto blocksModel { getParsedBlocksModel(chNum) };
+    if (blocksModel == nullptr) {
+        return false;
+    }
+
     QFile f(fileName.isEmpty() ? QString("tape_%1_%2.tap").arg(QDateTime::currentDateTime().toString("dd.MM.yyyy hh-mm-ss.zzz")).arg(chNum ? "R" : "L") : fileName);
     f.remove(); //Remove file if exists
-    f.open(QIODevice::WriteOnly);
+    if (!f.open(QIODevice::WriteOnly)) {
+        qDebug() << "Can't open TAP file for writing:" << f.fileName();
+        return false;
+    }
 
-    auto parsedDataSPtr { parsedDataPtr->getParsedData() };
-    auto& parsedData = *parsedDataSPtr.data();
+    const auto snapshot { getSnapshot(chNum) };
+    const auto& parsedData { snapshot->blocks };
     for (auto i = 0; i < parsedData.size(); ++i) {
-        if (i < mSelectedBlocks.size() && !mSelectedBlocks[i]) {
+        if (!blocksModel->isSelected(i)) {
             continue;
         }
 
@@ -337,46 +722,19 @@ void WaveformParser::saveTap(uint chNum, const QString& fileName)
         const uint16_t size = data.size();
         b.append(reinterpret_cast<const char *>(&size), sizeof(size));
         b.append(reinterpret_cast<const char *>(data.data()), size);
-        f.write(b);
+        if (f.write(b) != b.size()) {
+            return false;
+        }
     }
 
     f.close();
-}
-
-QVector<uint8_t> WaveformParser::getParsedWaveform(uint chNum) const {
-    auto parsedDataPtr { getParsedDataPtr(chNum) };
-    if (parsedDataPtr == nullptr) {
-        return {};
-    }
-    return *parsedDataPtr->getParsedWaveform();// mParsedWaveform[chNum];
-}
-
-QPair<QVector<ParsedData::DataBlock>, QVector<bool>> WaveformParser::getParsedData(uint chNum) const {
-    auto parsedDataPtr { getParsedDataPtr(chNum) };
-    if (parsedDataPtr == nullptr) {
-        return {};
-    }
-    return { *parsedDataPtr->getParsedData(), mSelectedBlocks };
-}
-
-void WaveformParser::toggleBlockSelection(int blockNum) {
-    if (blockNum < mSelectedBlocks.size()) {
-        auto& blk = mSelectedBlocks[blockNum];
-        blk = !blk;
-
-        emit parsedChannel0Changed();
-        emit parsedChannel1Changed();
-    }
+    return true;
 }
 
 int WaveformParser::getBlockDataStart(uint chNum, uint blockNum) const
 {
-    auto parsedDataPtr { getParsedDataPtr(chNum) };
-    if (parsedDataPtr == nullptr) {
-        return 0;
-    }
-    auto parsedDataSPtr { parsedDataPtr->getParsedData() };
-    auto& parsedData { *parsedDataSPtr };
+    const auto snapshot { getSnapshot(chNum) };
+    const auto& parsedData { snapshot->blocks };
 
     if (blockNum < (unsigned) parsedData.size()) {
         return parsedData[blockNum].dataStart;
@@ -386,12 +744,8 @@ int WaveformParser::getBlockDataStart(uint chNum, uint blockNum) const
 
 int WaveformParser::getBlockDataEnd(uint chNum, uint blockNum) const
 {
-    auto parsedDataPtr { getParsedDataPtr(chNum) };
-    if (parsedDataPtr == nullptr) {
-        return 0;
-    }
-    auto parsedDataSPtr { parsedDataPtr->getParsedData() };
-    auto& parsedData { *parsedDataSPtr };
+    const auto snapshot { getSnapshot(chNum) };
+    const auto& parsedData { snapshot->blocks };
 
     if (blockNum < (unsigned) parsedData.size()) {
         return parsedData[blockNum].dataEnd;
@@ -401,97 +755,56 @@ int WaveformParser::getBlockDataEnd(uint chNum, uint blockNum) const
 
 int WaveformParser::getPositionByAddress(uint chNum, uint blockNum, uint addr) const
 {
-    auto parsedDataPtr { getParsedDataPtr(chNum) };
-    if (parsedDataPtr == nullptr) {
-        return 0;
-    }
-    auto parsedDataSPtr { parsedDataPtr->getParsedData() };
-    auto& parsedData { *parsedDataSPtr };
+    const auto snapshot { getSnapshot(chNum) };
+    const auto& parsedData { snapshot->blocks };
 
-    if (blockNum < (unsigned) parsedData.size() && addr < (unsigned) parsedData[blockNum].waveformData.size()) {
-        return parsedData[blockNum].waveformData[addr].begin;
+    if (blockNum < (unsigned) parsedData.size() && addr < (unsigned) parsedData[blockNum].data.size()) {
+        return parsedData[blockNum].getByteBegin(addr);
     }
     return 0;
 }
 
-QVariantList WaveformParser::getParsedChannelData(uint chNum) const
+ParsedBlocksModel* WaveformParser::getParsedBlocksModel(uint chNum) const
 {
-    auto parsedDataPtr { getParsedDataPtr(chNum) };
-    if (parsedDataPtr == nullptr) {
-        return {};
-    }
-    auto parsedDataSPtr { parsedDataPtr->getParsedData() };
-    auto& parsedData { *parsedDataSPtr };
+    return m_parsedBlocksModels.value(chNum, nullptr);
+}
 
-    static QMap<int, QString> blockTypes {
-        {0x00, "Program"},
-        {0x01, "Number Array"},
-        {0x02, "Character Array"},
-        {0x03, "Bytes"}
-    };
-    const QString id_header { qtTrId(ID_HEADER) };
-    const QString id_code { qtTrId(ID_CODE) };
-    const QString id_ok { qtTrId(ID_OK) };
-    const QString id_error { qtTrId(ID_ERROR) };
-    const QString id_unknown { qtTrId(ID_UNKNOWN) };
-
-    QVariantList r;
-    uint blockNumber = 0;
-
-    for (const auto& i: parsedData) {
-        QVariantMap m;
-
-        m.insert("block", QVariantMap { {"blockSelected", blockNumber < (unsigned) mSelectedBlocks.size() ? mSelectedBlocks[blockNumber] : (mSelectedBlocks.append(true), true)}, {"blockNumber", blockNumber++} });
-        if (i.data.size() > 0) {
-            auto d = i.data.at(0);
-            int blockType = -1;
-            auto btIt = blockTypes.end();
-            QString blockTypeName;
-            if (d == 0x00 && i.data.size() > 1) {
-                d = i.data.at(1);
-                btIt = blockTypes.find(d);
-                blockType = btIt == blockTypes.end() ? -1 : d;
-                blockTypeName = blockType == -1 ? QString::number(d, 16) : *btIt;
-            }
-            else {
-                blockType = -2;
-                blockTypeName = d == 0x00 ? id_header : id_code;
-            }
-            m.insert("blockType", blockTypeName);
-            QString sizeText = QString::number(i.data.size());
-            if (i.data.size() > 13 && btIt != blockTypes.end()) {
-                sizeText += QString(" (%1)").arg(i.data.at(13) * 256 + i.data.at(12));
-            }
-            m.insert("blockSize", sizeText);
-            QString nameText;
-            if (blockType >= 0) {
-                const auto loopRange { std::min(decltype(i.data.size())(12), i.data.size()) };
-                nameText = QByteArray((const char*) &i.data.data()[2], loopRange > 1 ? loopRange - 2 : 0);
-            }
-            m.insert("blockName", nameText);
-            m.insert("blockStatus", (i.state == ParsedData::OK ? id_ok : id_error) + qtTrId(ID_PARITY_MESSAGE).arg(QString::number(i.parityCalculated, 16).toUpper().rightJustified(2, '0')).arg(QString::number(i.parityAwaited, 16).toUpper().rightJustified(2, '0')));
-            m.insert("state", i.state);
-        }
-        else {
-            m.insert("blockType", id_unknown);
-            m.insert("blockName", QString());
-            m.insert("blockSize", 0);
-            m.insert("blockStatus", id_unknown);
+ParsedBlocksModel* WaveformParser::getParsedChannel0() const
+{
+    return getParsedBlocksModel(0);
+}
+
+ParsedBlocksModel* WaveformParser::getParsedChannel1() const
+{
+    return getParsedBlocksModel(1);
+}
+
+bool WaveformParser::getAutoTuning() const
+{
+    return m_autoTuneWatcher != nullptr;
+}
+
+QVariantList WaveformParser::getBitRepairs() const
+{
+    QVariantList result;
+    for (const auto& c: m_bitRepairs) {
+        QStringList flips;
+        for (const auto& f: c.flips) {
+            flips.append(qtTrId(ID_BIT_FLIP).arg(f.byteIndex).arg(7 - f.bitIndex).arg(f.toOne ? 0 : 1).arg(f.toOne ? 1 : 0));
         }
-        r.append(m);
+        result.append(QVariantMap { { "flips", flips.join("; ") }, { "cost", QString::number(c.cost, 'f', 3) } });
     }
-
-    return r;
+    return result;
 }
 
-QVariantList WaveformParser::getParsedChannel0() const
+bool WaveformParser::getSearchingBitRepairs() const
 {
-    return getParsedChannelData(0);
+    return m_bitRepairWatcher != nullptr;
 }
 
-QVariantList WaveformParser::getParsedChannel1() const
+bool WaveformParser::getBitRepairsValid() const
 {
-    return getParsedChannelData(1);
+    return m_bitRepairsValid;
 }
 
 WaveformParser* WaveformParser::instance()
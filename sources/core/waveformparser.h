@@ -15,20 +15,35 @@
 #define WAVEFORMPARSER_H
 
 #include <iterator>
+#include <optional>
+#include <QFutureWatcher>
 #include <QMap>
+#include <QMutex>
+#include <QWeakPointer>
 #include <QVector>
 #include <QVariantMap>
 #include <QVariantList>
+#include "sources/core/bitrepairsolver.h"
 #include "sources/core/parseddata.h"
+#include "sources/core/halfwaveclassifier.h"
+#include "sources/core/halfwaveparser.h"
+#include "sources/core/halfwavescanner.h"
+#include "sources/core/halfwavestore.h"
+#include "sources/core/parsersettingstuner.h"
 #include "sources/core/wavreader.h"
+#include "sources/models/parsedblocksmodel.h"
 #include "sources/defines.h"
 
 class WaveformParser : public QObject
 {
     Q_OBJECT
 
-    Q_PROPERTY(QVariantList parsedChannel0 READ getParsedChannel0 NOTIFY parsedChannel0Changed)
-    Q_PROPERTY(QVariantList parsedChannel1 READ getParsedChannel1 NOTIFY parsedChannel1Changed)
+    Q_PROPERTY(ParsedBlocksModel* parsedChannel0 READ getParsedChannel0 CONSTANT)
+    Q_PROPERTY(ParsedBlocksModel* parsedChannel1 READ getParsedChannel1 CONSTANT)
+    Q_PROPERTY(bool autoTuning READ getAutoTuning NOTIFY autoTuningChanged)
+    Q_PROPERTY(QVariantList bitRepairs READ getBitRepairs NOTIFY bitRepairsChanged)
+    Q_PROPERTY(bool searchingBitRepairs READ getSearchingBitRepairs NOTIFY searchingBitRepairsChanged)
+    Q_PROPERTY(bool bitRepairsValid READ getBitRepairsValid NOTIFY bitRepairsChanged)
 
 public:
 //    enum SignalValue { ZERO, ONE, PILOT, SYNCHRO };
@@ -42,49 +57,69 @@ public:
 //    };
 
 private:
-    enum StateType { SEARCH_OF_PILOT_TONE, PILOT_TONE, SYNCHRO_SIGNAL, DATA_SIGNAL, END_OF_DATA, NO_MORE_DATA };
-
     template <typename T>
-    QVector<ParsedData::WaveformPart> parseChannel(const QVector<T>& ch) {
-        decltype(parseChannel(ch)) result;
-        if (ch.size() < 1) {
-            return result;
-        }
-
-        auto it = ch.begin();
-        auto val = *it;
-        while (it != ch.end()) {
-            auto prevIt = it;
-            it = std::find_if(it, ch.end(), [&val](const T& i) { return lessThanZero(val) != lessThanZero(i); });
-            typename std::remove_reference<decltype(*result.begin())>::type part;
-            part.begin = std::distance(ch.begin(), prevIt);
-            part.end = std::distance(ch.begin(), std::prev(it));
-            part.length = std::distance(prevIt, it);
-            part.sign = lessThanZero(val) ? ParsedData::NEGATIVE : ParsedData::POSITIVE;
-
-            result.append(part);
-
-            if (it != ch.end()) {
-                val = *it;
-            }
-        }
+    HalfWaveStore parseChannel(const QVector<T>& ch) {
+        HalfWaveStore result;
+        HalfWaveScanner scanner([&result](const ParsedData::WaveformPart& p) { result.append(p); });
+        scanner.feed(ch.constData(), ch.size());
+        scanner.finish();
+        result.squeeze();
 
         return result;
     }
 
-    //Helper methods intended to use in case of change we can made them only once
-    __attribute__((always_inline)) inline bool isZeroFreqFitsInDelta(uint32_t sampleRate, uint32_t length, uint32_t signalFreq, double signalDeltaBelow, double signalDeltaAbove) const;
-    __attribute__((always_inline)) inline bool isOneFreqFitsInDelta(uint32_t sampleRate, uint32_t length, uint32_t signalFreq, double signalDeltaBelow, double signalDeltaAbove) const;
+    //Parses the channels concurrently without notifying about the changes, returns the channels actually parsed
+    QVector<uint> parseChannels(const QVector<uint>& channels);
+    void notifyParsedChannelChanged(uint chNum);
+
+    //Returns the half-waves cached for the current content of the channel or null if there are no such half-waves
+    QSharedPointer<const HalfWaveStore> getCachedHalfWaves(uint chNum, const QSharedPointer<QWavVector>& channel) const;
+    //Returns the classifier for the current parser settings and sample rate, it is built again only if they are changed
+    QSharedPointer<const HalfWaveClassifier> getClassifier();
+    void clearBitRepairs(uint chNum);
+
+    //Channel the parsed data corresponds to and the range of samples edited in place since it was parsed
+    struct ParsedChannelState
+    {
+        QWeakPointer<QWavVector> channel;
+        QWavVector::size_type size;
+        ParserSettingsModel::ParserSettings settings;
+        bool edited;
+        uint64_t editBegin;
+        uint64_t editEnd;
+    };
+
+    //Half-waves found by the last complete parsing of the channel, valid while the channel content version is the same
+    struct HalfWaveCache
+    {
+        QWeakPointer<QWavVector> channel;
+        uint64_t version;
+        QSharedPointer<const HalfWaveStore> halfWaves;
+    };
 
     WavReader& mWavReader;
     QMap<uint, ParsedData*> m_parsedData;
+    QMap<uint, ParsedChannelState> m_parsedChannelStates;
+    //Content version of every channel, bumped by any change of its samples
+    QMap<uint, uint64_t> m_channelVersions;
+    QMap<uint, HalfWaveCache> m_halfWaveCaches;
+    QSharedPointer<const HalfWaveClassifier> m_classifier;
+    QFutureWatcher<ParserSettingsTuner::Result>* m_autoTuneWatcher;
+    QFutureWatcher<BitRepairSolver::Result>* m_bitRepairWatcher;
+    //Bit repairs found for the block of the channel, they are dropped when the channel content is changed
+    uint m_bitRepairsChannel;
+    QVector<BitRepairSolver::Candidate> m_bitRepairs;
+    bool m_bitRepairsValid;
     // QMap<uint, QVector<uint8_t>> mParsedWaveform;
     // QMap<uint, QVector<DataBlock>> mParsedData;
-    mutable QVector<bool> mSelectedBlocks;
+    //Parsed blocks of every channel shown by the views, they are updated once per parsing and keep the block selection
+    QVector<ParsedBlocksModel*> m_parsedBlocksModels;
+    //Last published parsing results, the lock guards only the swap and the copy of the handles
+    QMap<uint, ParsedData::SnapshotPtr> m_snapshots;
+    mutable QMutex m_snapshotsMutex;
 
 protected:
     explicit WaveformParser(QObject* parent = nullptr);
-    QVariantList getParsedChannelData(uint chNum) const;
     __attribute__((always_inline)) inline ParsedData* getOrCreateParsedDataPtr(uint chNum);
     __attribute__((always_inline)) inline ParsedData* getParsedDataPtr(uint chNum) const;
 
@@ -94,25 +129,49 @@ public:
     static WaveformParser* instance();
 
     void parse(uint chNum);
-    void saveTap(uint chNum, const QString& fileName = QString());
+    Q_INVOKABLE void parseAll();
+    //Samples of the channel are changed in place, so only the signals around them are parsed again next time.
+    //Every change bumps the channel content version, so the half-waves cached for the previous content aren't used any more
+    void markEdited(uint chNum, uint64_t begin, uint64_t end);
+    //The whole channel is changed, so it is parsed completely next time
+    void markChanged(uint chNum);
+    //Returns the half-waves of the channel, they are found and cached if the channel content is changed since the last parsing
+    QSharedPointer<const HalfWaveStore> getHalfWaves(uint chNum);
+    //Searches the parser settings giving the most of the correct blocks in the channel on the worker threads,
+    //found settings are applied to the parser settings model
+    Q_INVOKABLE void autoTuneSettings(uint chNum, int timeBudgetMs = 10000);
+    //Searches the bits of the block with the parity error to be flipped on the worker threads
+    Q_INVOKABLE void searchBitRepairs(uint chNum, uint blockNum, int timeBudgetMs = 5000);
+    std::optional<BitRepairSolver::Candidate> getBitRepair(int index) const;
+    uint getBitRepairsChannel() const;
+    //Parses all channels of the opened WAV file without decoding it into the channels, so the file size isn't limited by the memory
+    WavReader::ErrorCodesEnum parseStreamed(size_t windowFrames = WavReader::defaultStreamWindowFrames);
+    //Returns false if the file can't be written
+    bool saveTap(uint chNum, const QString& fileName = QString());
     void saveWaveform(uint chNum);
-    QVector<uint8_t> getParsedWaveform(uint chNum) const;
-    QPair<QVector<ParsedData::DataBlock>, QVector<bool>> getParsedData(uint chNum) const;
-    QSharedPointer<QVector<ParsedData::DataBlock>> getParsedDataSharedPtr(uint chNum) const;
+    //Returns the last published parsing result of the channel, which is empty if the channel isn't parsed yet.
+    //May be called from any thread, the snapshot is never changed and stays valid while it is held.
+    ParsedData::SnapshotPtr getSnapshot(uint chNum) const;
 
     void repairWaveform2(uint chNum);
 
-    Q_INVOKABLE void toggleBlockSelection(int blockNum);
     Q_INVOKABLE int getBlockDataStart(uint chNum, uint blockNum) const;
     Q_INVOKABLE int getBlockDataEnd(uint chNum, uint blockNum) const;
     Q_INVOKABLE int getPositionByAddress(uint chNum, uint blockNum, uint addr) const;
     //getters
-    QVariantList getParsedChannel0() const;
-    QVariantList getParsedChannel1() const;
+    ParsedBlocksModel* getParsedBlocksModel(uint chNum) const;
+    ParsedBlocksModel* getParsedChannel0() const;
+    ParsedBlocksModel* getParsedChannel1() const;
+    bool getAutoTuning() const;
+    QVariantList getBitRepairs() const;
+    bool getSearchingBitRepairs() const;
+    bool getBitRepairsValid() const;
 
 signals:
-    void parsedChannel0Changed();
-    void parsedChannel1Changed();
+    void autoTuningChanged();
+    void settingsAutoTuned(int okBlocks, int blocks);
+    void bitRepairsChanged();
+    void searchingBitRepairsChanged();
 };
 
 #endif // WAVEFORMPARSER_H
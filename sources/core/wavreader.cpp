@@ -12,18 +12,29 @@
 //*******************************************************************************
 
 #include "wavreader.h"
+#include "sampledecoder.h"
+#include "waveformcodec.h"
+#include "sources/configuration/configurationmanager.h"
 #include "sources/models/suspiciouspointsmodel.h"
-#include "sources/models/parsersettingsmodel.h"
 #include "sources/models/waveformmodel.h"
 #include <QVariant>
 #include <QVariantList>
 #include <QDateTime>
 #include <QDebug>
 #include <QScopeGuard>
+#include <QThread>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 WavReader::WavReader(QObject* parent) :
     QObject(parent),
+    mDataOffset(0),
+    mDataSize(0),
     mWavOpened(false),
+    mLoadingMode(MemoryMappedLoading),
+    mWaveformCompression(ConfigurationManager::instance()->getApplicationCustomization()->waveformCompression()),
     mChannel0(nullptr),
     mChannel1(nullptr)
 {
@@ -47,15 +58,36 @@ WavReader::ErrorCodesEnum WavReader::open()
             mWavOpened = false;
             QByteArray buf;
 
+            bool rf64 = false;
+            uint64_t rf64DataSize = 0;
             {
                 const WavHeader* riffHeader = readData<WavHeader>(buf);
-                if (!riffHeader || riffHeader->chunk.chunkId != riffId || riffHeader->riffType != waveId) {
+                if (!riffHeader || (riffHeader->chunk.chunkId != riffId && riffHeader->chunk.chunkId != rf64Id) || riffHeader->riffType != waveId) {
                     mWavFile.close();
                     return InvalidWavFormat;
                 }
+                rf64 = riffHeader->chunk.chunkId == rf64Id;
+            }
+
+            if (rf64) {
+                //ds64 chunk is mandatory and should be the first one of RF64 file
+                const WavDs64* ds64Header = readData<WavDs64>(buf);
+                if (!ds64Header || ds64Header->chunk.chunkId != ds64Id || ds64Header->chunk.chunkDataSize < sizeof (WavDs64) - sizeof (WavChunk)) {
+                    mWavFile.close();
+                    return InvalidWavFormat;
+                }
+                rf64DataSize = ds64Header->dataSize;
+
+                //Skipping the table of other chunk sizes
+                mWavFile.seek(mWavFile.pos() + (ds64Header->chunk.chunkDataSize - (sizeof (WavDs64) - sizeof (WavChunk))));
             }
 
             {
+                if (!seekToChunk(fmt_Id)) {
+                    mWavFile.close();
+                    return InvalidWavFormat;
+                }
+
                 const WavFmt* fmtHeader = readData<WavFmt>(buf);
                 if (!fmtHeader || fmtHeader->chunk.chunkId != fmt_Id) {
                     mWavFile.close();
@@ -76,13 +108,14 @@ WavReader::ErrorCodesEnum WavReader::open()
             }
 
             {
-                const WavChunk* dataHeader = readData<WavChunk>(buf);
+                const WavChunk* dataHeader = seekToChunk(dataId) ? readData<WavChunk>(buf) : nullptr;
                 if (!dataHeader || dataHeader->chunkId != dataId) {
                     mWavFile.close();
                     return InvalidWavFormat;
                 }
 
-                mCurrentChunk = *dataHeader;
+                mDataSize = rf64 && dataHeader->chunkDataSize == 0xFFFFFFFF ? rf64DataSize : dataHeader->chunkDataSize;
+                mDataOffset = mWavFile.pos();
             }
 
             mWavOpened = true;
@@ -95,83 +128,162 @@ WavReader::ErrorCodesEnum WavReader::open()
     return AlreadyOpened;
 }
 
-QWavVectorType WavReader::getSample(QByteArray& buf, size_t& bufIndex, uint dataSize, uint compressionCode) const
+bool WavReader::seekToChunk(uint32_t chunkId)
 {
-       QWavVectorType r { };
-       void* v;
-       v = reinterpret_cast<void*>(getData(buf, bufIndex, dataSize));
-
-       switch (dataSize) {
-           case 1:
-               r = (*reinterpret_cast<uint8_t*>(v) - 128) * 258.;
-               break;
-
-           case 2:
-               r = *reinterpret_cast<int16_t*>(v);
-               break;
-
-           case 3:
-               {
-                   Int24* t;
-                   t = reinterpret_cast<Int24*>(v);
-                   r = ((t->b2 << 16) | (t->b1 << 8) | t->b0);
-               }
-               break;
-
-           case 4:
-               r = compressionCode == 3 ? *reinterpret_cast<float*>(v) : *reinterpret_cast<int32_t*>(v);
-               break;
+    QByteArray buf;
+    const WavChunk* chunk;
+    while ((chunk = readData<WavChunk>(buf)) != nullptr) {
+        if (chunk->chunkId == chunkId) {
+            //Leave the file positioned at the chunk header
+            return mWavFile.seek(mWavFile.pos() - sizeof (WavChunk));
+        }
 
-           default:
-               qDebug() << "Unsupported data size";
-               break;
-       }
+        //Skipping unknown chunk (LIST, JUNK, bext etc.), chunks are word aligned
+        if (!mWavFile.seek(mWavFile.pos() + chunk->chunkDataSize + (chunk->chunkDataSize & 1))) {
+            return false;
+        }
+    }
 
-       return r;
+    return false;
 }
 
 QWavVector* WavReader::createVector(size_t bytesPerSample, size_t size)
 {
-    Q_UNUSED(bytesPerSample)
-    return new QWavVector(static_cast<int>(size));
+    //8 and 16-bit samples are kept as int16 without loss of precision
+    return new QWavVector(bytesPerSample <= sizeof(int16_t) ? QWavVector::Int16Samples : QWavVector::FloatSamples, static_cast<QWavVector::size_type>(size));
 }
 
-WavReader::ErrorCodesEnum WavReader::read()
+bool WavReader::decodeChannels(const uint8_t* data, size_t frames, QWavVector& ch0, QWavVector* ch1, size_t offset) const
+{
+    return ch0.visit([this, data, frames, ch1, offset](auto& samples) {
+        using T = typename std::decay_t<decltype(samples)>::value_type;
+        const auto decode { SampleDecoder::getDecodeFunction<T>(mWavFormatHeader.compressionCode, mWavFormatHeader.significantBitsPerSample, mWavFormatHeader.numberOfChannels) };
+        if (!decode) {
+            return false;
+        }
+
+        decode(data, frames, samples.data() + offset, ch1 ? ch1->as<T>().data() + offset : nullptr);
+        return true;
+    });
+}
+
+WavReader::ErrorCodesEnum WavReader::read(const ProgressCallback& progress)
 {
     if (!mWavOpened) {
         return NotOpened;
     }
 
-    QByteArray buf { mWavFile.read(mCurrentChunk.chunkDataSize) };
-    if (buf.size() < static_cast<int>(mCurrentChunk.chunkDataSize)) {
+    const qint64 dataOffset = mDataOffset;
+    if (static_cast<uint64_t>(mWavFile.size()) < dataOffset + mDataSize) {
         return InsufficientData;
     }
 
-    mChannel0.reset(nullptr);
-    mChannel1.reset(nullptr);
+    //Channels can't exceed the maximum container size, such files can only be processed by streaming
+    const size_t frameSize = mWavFormatHeader.significantBitsPerSample / 8 * mWavFormatHeader.numberOfChannels;
+    if (mDataSize / frameSize > static_cast<uint64_t>(std::numeric_limits<QWavVector::size_type>::max())) {
+        return DataTooLarge;
+    }
+
+    //Memory-mapped data is decoded straight from the page cache, so no intermediate copy of the data chunk is made
+    QByteArray buf;
+    uchar* mappedData { mLoadingMode == MemoryMappedLoading ? mWavFile.map(dataOffset, mDataSize) : nullptr };
+    const auto unmapGuard = qScopeGuard([this, mappedData]() {
+        if (mappedData) {
+            mWavFile.unmap(mappedData);
+        }
+    });
+    if (!mappedData) {
+        if (mLoadingMode == MemoryMappedLoading) {
+            qDebug() << "Unable to map WAV data chunk, falling back to buffered loading: " << mWavFile.errorString();
+        }
+
+        if (mDataSize > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            return DataTooLarge;
+        }
+
+        if (!mWavFile.seek(dataOffset)) {
+            return InsufficientData;
+        }
+        buf = mWavFile.read(mDataSize);
+        if (static_cast<uint64_t>(buf.size()) < mDataSize) {
+            return InsufficientData;
+        }
+    }
+    const uint8_t* data { mappedData ? mappedData : reinterpret_cast<const uint8_t*>(buf.constData()) };
 
     size_t bytesPerSample = mWavFormatHeader.significantBitsPerSample / 8;
-    size_t numSamples = mCurrentChunk.chunkDataSize / (bytesPerSample * mWavFormatHeader.numberOfChannels);
+    size_t numSamples = mDataSize / (bytesPerSample * mWavFormatHeader.numberOfChannels);
+
+    //Channels are decoded aside, so the previously loaded ones stay valid until the loading is completed
+    QSharedPointer<QWavVector> ch0 { createVector(bytesPerSample, numSamples) };
+    QSharedPointer<QWavVector> ch1 { mWavFormatHeader.numberOfChannels == 2 ? createVector(bytesPerSample, numSamples) : nullptr };
+
+    //Data is decoded by windows to report the progress and to allow cancelling between them
+    for (size_t frame = 0; frame < numSamples; frame += defaultStreamWindowFrames) {
+        const size_t frames = std::min(defaultStreamWindowFrames, numSamples - frame);
+        if (!decodeChannels(data + frame * frameSize, frames, *ch0, ch1.data(), frame)) {
+            return UnsupportedWavFormat;
+        }
 
-    mChannel0.reset(createVector(bytesPerSample, numSamples));
-    if (mWavFormatHeader.numberOfChannels == 2) {
-        mChannel1.reset(createVector(bytesPerSample, numSamples));
+        if (progress && !progress((frame + frames) * frameSize, mDataSize)) {
+            return Cancelled;
+        }
     }
 
-    size_t bufIndex = 0;
-    QVector<size_t> channelBufIndex(mWavFormatHeader.numberOfChannels, 0);
-    for (size_t i = 0; i < numSamples; ++i) {
-        for (int channelNum = 0; channelNum < mWavFormatHeader.numberOfChannels; ++channelNum) {
-            auto& channel = channelNum == 0 ? mChannel0 : mChannel1;
-            auto& cbi = channelBufIndex[channelNum];
+    mChannel0 = ch0;
+    mChannel1 = ch1;
+    return Ok;
+}
+
+WavReader::ErrorCodesEnum WavReader::readStreamed(const StreamConsumer& consumer, size_t windowFrames)
+{
+    if (!mWavOpened) {
+        return NotOpened;
+    }
+
+    //Every window is read from its own offset, so the file may be streamed or read again at any time
+    const qint64 dataOffset = mDataOffset;
+    if (static_cast<uint64_t>(mWavFile.size()) < dataOffset + mDataSize) {
+        return InsufficientData;
+    }
+
+    const size_t bytesPerSample = mWavFormatHeader.significantBitsPerSample / 8;
+    const size_t frameSize = bytesPerSample * mWavFormatHeader.numberOfChannels;
+    const size_t numSamples = mDataSize / frameSize;
+    windowFrames = std::max<size_t>(1, std::min(windowFrames, numSamples));
+
+    //Window buffers are allocated once, so the memory consumption doesn't depend on the file size
+    QScopedPointer<QWavVector> ch0 { createVector(bytesPerSample, windowFrames) };
+    QScopedPointer<QWavVector> ch1 { createVector(bytesPerSample, mWavFormatHeader.numberOfChannels == 2 ? windowFrames : 0) };
+    QByteArray buf;
+
+    for (size_t frame = 0; frame < numSamples; frame += windowFrames) {
+        const size_t frames = std::min(windowFrames, numSamples - frame);
+        const qint64 windowOffset = dataOffset + frame * frameSize;
+        const qint64 windowSize = frames * frameSize;
+
+        uchar* mappedData { mLoadingMode == MemoryMappedLoading ? mWavFile.map(windowOffset, windowSize) : nullptr };
+        if (!mappedData) {
+            buf.resize(windowSize);
+            if (!mWavFile.seek(windowOffset) || mWavFile.read(buf.data(), windowSize) < windowSize) {
+                return InsufficientData;
+            }
+        }
+
+        const bool decoded { decodeChannels(mappedData ? mappedData : reinterpret_cast<const uint8_t*>(buf.constData()), frames, *ch0, ch1->isEmpty() ? nullptr : ch1.data()) };
+        if (mappedData) {
+            mWavFile.unmap(mappedData);
+        }
+
+        if (!decoded) {
+            return UnsupportedWavFormat;
+        }
 
-            channel->operator[](cbi) = getSample(buf, bufIndex, bytesPerSample, mWavFormatHeader.compressionCode);
-            ++cbi;
+        if (!consumer(*ch0, *ch1, frames)) {
+            break;
         }
     }
 
-    WaveFormModel::instance()->initialize({ getChannel0(), getChannel1() });
-    emit numberOfChannelsChanged();
     return Ok;
 }
 
@@ -190,6 +302,13 @@ uint WavReader::getBytesPerSample() const
     return mWavOpened ? mWavFormatHeader.significantBitsPerSample / 8 : 0;
 }
 
+//Number of samples per channel in the data chunk of the opened WAV file
+uint64_t WavReader::getNumberOfFrames() const
+{
+    const uint64_t frameSize { getBytesPerSample() * getNumberOfChannels() };
+    return frameSize == 0 ? 0 : mDataSize / frameSize;
+}
+
 QSharedPointer<QWavVector> WavReader::getChannel0() const
 {
     return mChannel0;
@@ -200,6 +319,37 @@ QSharedPointer<QWavVector> WavReader::getChannel1() const
     return mChannel1;
 }
 
+WavReader::LoadingMode WavReader::getLoadingMode() const
+{
+    return mLoadingMode;
+}
+
+bool WavReader::getWaveformCompression() const
+{
+    return mWaveformCompression;
+}
+
+void WavReader::setLoadingMode(LoadingMode mode)
+{
+    if (mLoadingMode != mode) {
+        mLoadingMode = mode;
+        emit loadingModeChanged();
+    }
+}
+
+void WavReader::setWaveformCompression(bool compression)
+{
+    if (mWaveformCompression != compression) {
+        mWaveformCompression = compression;
+
+        auto& cm { *ConfigurationManager::instance() };
+        cm.getApplicationCustomization()->setWaveformCompression(compression);
+        cm.writeConfiguration();
+
+        emit waveformCompressionChanged();
+    }
+}
+
 WavReader::ErrorCodesEnum WavReader::close()
 {
     if (!mWavOpened) {
@@ -211,24 +361,65 @@ WavReader::ErrorCodesEnum WavReader::close()
     return Ok;
 }
 
-void WavReader::loadWaveform(const QString& fname)
+namespace {
+    //Waveform may be loaded by the worker thread, so the model is updated in its own thread
+    void restoreSuspiciousPoints(const QVariantList& sp)
+    {
+        QMetaObject::invokeMethod(SuspiciousPointsModel::instance(), [sp]() {
+            SuspiciousPointsModel::instance()->setSuspiciousPoints(sp);
+        });
+    }
+
+    uint64_t alignWfmOffset(uint64_t offset, uint64_t alignment)
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+}
+
+WavReader::ErrorCodesEnum WavReader::loadWaveform(const QString& fname, const ProgressCallback& progress)
 {
     QFile f(fname);
-    f.open(QIODevice::ReadOnly);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return CantOpen;
+    }
+
+    //v1 files start with the WAV format header and have no file id
+    uint32_t fileId { 0 };
+    if (f.peek(reinterpret_cast<char*>(&fileId), sizeof(fileId)) != sizeof(fileId)) {
+        return InsufficientData;
+    }
+
+    const auto result { fileId == wfmId ? loadWaveformV2(f, progress) : loadWaveformV1(f, progress) };
+    f.close();
+    if (result == Ok) {
+        mWavOpened = true;
+    }
+    return result;
+}
+
+WavReader::ErrorCodesEnum WavReader::loadWaveformV1(QFile& f, const ProgressCallback& progress)
+{
     QByteArray b(f.read(f.size()));
     size_t idx = 0;
     //Get header
     mWavFormatHeader = *getData<WavFmt>(b, idx);
+    QSharedPointer<QWavVector> channels[2];
     for (auto i = 0; i < mWavFormatHeader.numberOfChannels; ++i) {
         //Get channel length
         const int32_t l { *getData<int32_t>(b, idx) };
-        auto& ch = i == 0 ? mChannel0 : mChannel1;
-        ch.reset(new QWavVector(l));
+        auto& ch = channels[i];
+        ch.reset(new QWavVector(QWavVector::FloatSamples, l));
         //Fill channel data
-        for (auto& v: *ch.get()) {
-            v = *getData<QWavVectorType>(b, idx);
+        for (auto& v: ch->as<float>()) {
+            v = *getData<float>(b, idx);
+        }
+
+        if (progress && !progress(idx, b.size())) {
+            return Cancelled;
         }
     }
+    mChannel0 = channels[0];
+    mChannel1 = channels[1];
 
     //Restore suspicious points
     const int32_t l { *getData<int32_t>(b, idx) };
@@ -236,11 +427,153 @@ void WavReader::loadWaveform(const QString& fname)
     for (auto i = 0; i < l; ++i) {
         sp.append(*getData<uint32_t>(b, idx));
     }
-    SuspiciousPointsModel::instance()->setSuspiciousPoints(sp);
+    restoreSuspiciousPoints(sp);
 
-    f.close();
-    WaveFormModel::instance()->initialize({ getChannel0(), getChannel1() });
-    mWavOpened = true;
+    return Ok;
+}
+
+WavReader::ErrorCodesEnum WavReader::loadWaveformV2(QFile& f, const ProgressCallback& progress)
+{
+    QByteArray buf;
+    const WfmHeader* header { readData<WfmHeader>(buf, f) };
+    if (!header) {
+        return InsufficientData;
+    }
+    if (header->version != wfmVersion) {
+        return UnsupportedWavFormat;
+    }
+    const WavFmt format { header->format };
+
+    const uint64_t fileSize = f.size();
+    const qint64 tocSize = header->sectionsCount * sizeof(WfmSection);
+    QVector<WfmSection> sections(header->sectionsCount);
+    if (f.read(reinterpret_cast<char*>(sections.data()), tocSize) != tocSize) {
+        return InsufficientData;
+    }
+
+    uint64_t totalSize { 0 };
+    bool hasChannel0 { false };
+    bool hasChannel1 { false };
+    for (const auto& section: sections) {
+        if (section.offset > fileSize || section.size > fileSize - section.offset) {
+            return InsufficientData;
+        }
+        totalSize += section.size;
+        hasChannel0 = hasChannel0 || section.sectionId == wfmChannel0Id;
+        hasChannel1 = hasChannel1 || section.sectionId == wfmChannel1Id;
+    }
+
+    //Every channel declared by the format has to be stored, otherwise the channel would be left without data
+    if ((format.numberOfChannels != 1 && format.numberOfChannels != 2) || !hasChannel0 || (format.numberOfChannels == 2 && !hasChannel1)) {
+        return InvalidWavFormat;
+    }
+
+    QSharedPointer<QWavVector> channels[2];
+    QVariantList sp;
+    uint64_t processed { 0 };
+    bool cancelled { false };
+    for (const auto& section: sections) {
+        if (section.sectionId == wfmChannel0Id || section.sectionId == wfmChannel1Id) {
+            if (section.sampleType != QWavVector::Int16Samples && section.sampleType != QWavVector::FloatSamples) {
+                return UnsupportedWavFormat;
+            }
+
+            if (section.codec != WaveformCodec::NoCodec && section.codec != WaveformCodec::PredictiveRiceCodec) {
+                return UnsupportedWavFormat;
+            }
+
+            const auto sampleType { static_cast<QWavVector::SampleType>(section.sampleType) };
+            auto& ch { channels[section.sectionId == wfmChannel0Id ? 0 : 1] };
+            if (section.codec == WaveformCodec::PredictiveRiceCodec) {
+                //Compressed section is decoded as a whole, the codec itself splits the work by chunks between the threads
+                ch.reset(new QWavVector(sampleType, 0));
+                uchar* mappedData { f.map(section.offset, section.size) };
+                const auto unmapGuard = qScopeGuard([&f, mappedData]() {
+                    if (mappedData) {
+                        f.unmap(mappedData);
+                    }
+                });
+                QByteArray data;
+                if (!mappedData) {
+                    if (!f.seek(section.offset)) {
+                        return InsufficientData;
+                    }
+                    data = f.read(section.size);
+                    if (static_cast<uint64_t>(data.size()) != section.size) {
+                        return InsufficientData;
+                    }
+                }
+
+                const uint8_t* coded { mappedData ? mappedData : reinterpret_cast<const uint8_t*>(data.constData()) };
+                if (!WaveformCodec::decode(coded, section.size, *ch)) {
+                    return InvalidWavFormat;
+                }
+
+                processed += section.size;
+                if (progress && !progress(processed, totalSize)) {
+                    return Cancelled;
+                }
+                continue;
+            }
+
+            const uint64_t sampleSize { sampleType == QWavVector::Int16Samples ? sizeof(int16_t) : sizeof(float) };
+            if (section.size / sampleSize > static_cast<uint64_t>(std::numeric_limits<QWavVector::size_type>::max())) {
+                return DataTooLarge;
+            }
+
+            ch.reset(new QWavVector(sampleType, static_cast<QWavVector::size_type>(section.size / sampleSize)));
+            const bool copied { ch->visit([&](auto& samples) {
+                //Section is copied into the channel by large blocks without any intermediate buffer. Every block is mapped
+                //and unmapped separately (section and block bounds are page-aligned), so only one block of the file is mapped at a time
+                const uint64_t bytes { samples.size() * sizeof(samples[0]) };
+                char* dst { reinterpret_cast<char*>(samples.data()) };
+                const uint64_t blockSize { 16 * 1024 * 1024 };
+                for (uint64_t pos = 0; pos < bytes; pos += blockSize) {
+                    const uint64_t size { std::min(blockSize, bytes - pos) };
+                    uchar* mappedData { f.map(section.offset + pos, size) };
+                    if (mappedData) {
+                        std::memcpy(dst + pos, mappedData, size);
+                        f.unmap(mappedData);
+                    } else if (!f.seek(section.offset + pos) || f.read(dst + pos, size) != static_cast<qint64>(size)) {
+                        return false;
+                    }
+
+                    if (progress && !progress(processed + pos + size, totalSize)) {
+                        cancelled = true;
+                        return false;
+                    }
+                }
+                return true;
+            }) };
+
+            if (!copied) {
+                return cancelled ? Cancelled : InsufficientData;
+            }
+        }
+        else if (section.sectionId == wfmSuspiciousPointsId) {
+            QVector<uint64_t> points(section.size / sizeof(uint64_t));
+            const qint64 size = points.size() * sizeof(uint64_t);
+            if (!f.seek(section.offset) || f.read(reinterpret_cast<char*>(points.data()), size) != size) {
+                return InsufficientData;
+            }
+
+            for (const auto& p: points) {
+                sp.append(static_cast<qulonglong>(p));
+            }
+        }
+        else {
+            qDebug() << "Skipping unknown waveform file section: " << Qt::hex << section.sectionId;
+        }
+
+        processed += section.size;
+    }
+
+    mWavFormatHeader = format;
+    mChannel0 = channels[0];
+    mChannel1 = channels[1];
+    restoreSuspiciousPoints(sp);
+
+    return Ok;
 }
 
 unsigned WavReader::calculateOnesInByte (uint8_t n) {
@@ -250,9 +583,11 @@ unsigned WavReader::calculateOnesInByte (uint8_t n) {
   return n;
 }
 
-void WavReader::loadTap(const QString& fname) {
+WavReader::ErrorCodesEnum WavReader::loadTap(const QString& fname, const ParserSettingsModel::ParserSettings& parserSettings, const ProgressCallback& progress) {
     QFile f(fname);
-    f.open(QIODevice::ReadOnly);
+    if (!f.open(QIODevice::ReadOnly)) {
+        return CantOpen;
+    }
     const auto guard = qScopeGuard([&f](){ f.close(); });
 
     const size_t fSize = f.size();
@@ -268,142 +603,176 @@ void WavReader::loadTap(const QString& fname) {
             16 //Significant bits per sample
     };
 
-    const auto& parserSettings = ParserSettingsModel::instance()->getParserSettings();
+    const size_t sampleRate { mWavFormatHeader.sampleRate };
+    const size_t oneHalfLen { sampleRate / (parserSettings.oneHalfFreq / 2 * 2) };
+    const size_t zeroHalfLen { sampleRate / (parserSettings.zeroHalfFreq / 2 * 2) };
+    const size_t synchroFirstHalfLen { sampleRate / parserSettings.synchroFirstHalfFreq };
+    const size_t synchroSecondHalfLen { sampleRate / parserSettings.synchroSecondHalfFreq };
+    const size_t pilotHalfLen { sampleRate / (parserSettings.pilotHalfFreq / 2 * 2) };
+    const size_t pilotLen { sampleRate * 3 / (pilotHalfLen * 2) * pilotHalfLen * 2 };
+    const size_t silenceLen { sampleRate / 2 };
+
+    //Every block starts with the same pilot tone and synchro pulse followed by the data, so the leader and
+    //the waveforms of all 256 byte values are precomputed and the blocks are rendered by copying them
+    const auto appendHalfWave = [](QVector<int16_t>& t, size_t len, bool positive) {
+        t.insert(t.size(), static_cast<int>(len), positive ? 32767 : -32767);
+    };
+
+    QVector<int16_t> leader;
+    leader.reserve(static_cast<int>(pilotLen + synchroFirstHalfLen + synchroSecondHalfLen));
+    for (size_t i { 0 }; i < pilotLen; i += pilotHalfLen * 2) {
+        appendHalfWave(leader, pilotHalfLen, false);
+        appendHalfWave(leader, pilotHalfLen, true);
+    }
+    appendHalfWave(leader, synchroFirstHalfLen, false);
+    appendHalfWave(leader, synchroSecondHalfLen, true);
 
-    const auto oneFreq { parserSettings.oneHalfFreq / 2 };
-    const auto oneHalfFreq { oneFreq * 2 };
-    const auto zeroFreq { parserSettings.zeroHalfFreq / 2 };
-    const auto zeroHalfFreq { zeroFreq * 2 };
-    const auto synchroFirstHalf { parserSettings.synchroFirstHalfFreq };
-    const auto synchroSecondHalf { parserSettings.synchroSecondHalfFreq };
-    const auto pilotFreq { parserSettings.pilotHalfFreq / 2 };
-    const auto pilotHalfFreq { pilotFreq * 2 };
-    const auto silence { 0.5 };
-    const auto pilotLen { 3 };
+    QVector<int16_t> silenceTemplate(static_cast<int>(silenceLen), -1);
+    if (silenceLen > 1) {
+        silenceTemplate[1] = 0;
+    }
 
-    //Check TAP file for correctness
+    QVector<int16_t> byteTemplates;
+    size_t byteOffsets[257];
+    byteOffsets[0] = 0;
+    for (unsigned byte { 0 }; byte < 256; ++byte) {
+        const auto ones { calculateOnesInByte(byte) };
+        byteOffsets[byte + 1] = byteOffsets[byte] + 2 * (ones * oneHalfLen + (8 - ones) * zeroHalfLen);
+    }
+    byteTemplates.reserve(static_cast<int>(byteOffsets[256]));
+    for (unsigned byte { 0 }; byte < 256; ++byte) {
+        for (int i { 7 }; i >= 0; --i) {
+            const auto len { byte & (1 << i) ? oneHalfLen : zeroHalfLen };
+            appendHalfWave(byteTemplates, len, false);
+            appendHalfWave(byteTemplates, len, true);
+        }
+    }
+
+    //Check TAP file for correctness and lay out the blocks within the waveform
+    struct TapBlock
+    {
+        size_t dataOffset;
+        size_t dataSize;
+        size_t wavOffset;
+    };
+
+    QVector<TapBlock> blocks;
     size_t pos { 0 };
-    bool err { false };
     size_t wavlen { 0 };
-    while (!err && pos < fSize) {
-        err = fSize <= pos + sizeof(uint16_t);
-        if (err) {
-            continue;
+    while (pos < fSize) {
+        if (fSize <= pos + sizeof(uint16_t)) {
+            return InsufficientData;
         }
 
         const uint16_t blockSize { *getData<uint16_t>(b, pos) };
-        err = fSize < pos + blockSize;
-        if (err) {
-            continue;
+        if (fSize < pos + blockSize) {
+            return InsufficientData;
         }
 
-        //Pilot
-        wavlen += mWavFormatHeader.sampleRate * pilotLen;
-        //Synchro
-        wavlen += mWavFormatHeader.sampleRate / synchroFirstHalf;
-        wavlen += mWavFormatHeader.sampleRate / synchroSecondHalf;
-
+        blocks.append(TapBlock { pos, blockSize, wavlen });
+        wavlen += leader.size() + silenceTemplate.size();
+        const uint8_t* data { reinterpret_cast<const uint8_t*>(b.constData()) + pos };
         for (size_t i { 0 }; i < blockSize; ++i) {
-            const uint8_t byte { *getData<uint8_t>(b, pos) };
-            const auto ones { calculateOnesInByte(byte) };
-            const size_t byteLen { ones * (mWavFormatHeader.sampleRate / oneFreq) + (8 - ones) * (mWavFormatHeader.sampleRate / zeroFreq) };
-
-            wavlen += byteLen;
+            wavlen += byteOffsets[data[i] + 1] - byteOffsets[data[i]];
         }
-
-        //Silence
-        wavlen += mWavFormatHeader.sampleRate * silence;
+        pos += blockSize;
     }
-    if (err) {
-        return;
+    if (wavlen > static_cast<size_t>(std::numeric_limits<QWavVector::size_type>::max())) {
+        return DataTooLarge;
     }
 
-    QWavVector v(wavlen, -1.);
-    size_t wavpos { 0 };
-    pos ^= pos;
-    while (pos < fSize) {
-        const uint16_t blockSize { *getData<uint16_t>(b, pos) };
-
-        //Pilot
-        wavlen = mWavFormatHeader.sampleRate / pilotHalfFreq;
-        auto threshold { mWavFormatHeader.sampleRate * pilotLen / (wavlen * 2) };
-        for (size_t i { 0 }; i < threshold; ++i) {
-            for (auto p { 0 }; p <= 1; ++p) {
-                const QWavVectorType val { QWavVectorType(32767 * (p ? 1 : -1)) };
-                for (size_t c { 0 }; c < wavlen; ++c) {
-                    v[wavpos++] = val;
-                }
-            }
-        }
-        //Synchro
-        for (auto w { 0 }; w <= 1; ++w) {
-            wavlen = mWavFormatHeader.sampleRate / (w ? synchroSecondHalf : synchroFirstHalf);
-            const QWavVectorType val { QWavVectorType(32767 * (w ? 1 : -1)) };
-            for (size_t c { 0 }; c < wavlen; ++c) {
-                v[wavpos++] = val;
-            }
+    QVector<int16_t> v(static_cast<int>(wavlen));
+    int16_t* wav { v.data() };
+    const auto renderBlock = [&](const TapBlock& block) {
+        int16_t* dst { std::copy(leader.cbegin(), leader.cend(), wav + block.wavOffset) };
+        const uint8_t* data { reinterpret_cast<const uint8_t*>(b.constData()) + block.dataOffset };
+        for (size_t i { 0 }; i < block.dataSize; ++i) {
+            dst = std::copy(byteTemplates.cbegin() + byteOffsets[data[i]], byteTemplates.cbegin() + byteOffsets[data[i] + 1], dst);
         }
+        std::copy(silenceTemplate.cbegin(), silenceTemplate.cend(), dst);
+    };
 
-        for (size_t i { 0 }; i < blockSize; ++i) {
-            const uint8_t byte { *getData<uint8_t>(b, pos) };
-            //const auto ones { calculateOnesInByte(byte) };
-            //const size_t byteLen { ones * (mWavFormatHeader.sampleRate / oneFreq) + (8 - ones) * (mWavFormatHeader.sampleRate / zeroFreq) };
-            for (int i { 7 }; i >= 0; --i) {
-                const uint8_t bit8 = 1 << i;
-                const auto bit { byte & bit8 };
-                wavlen = mWavFormatHeader.sampleRate / (bit == 0 ? zeroHalfFreq : oneHalfFreq);
-                for (auto b { 0 }; b <= 1; ++b) {
-                    const QWavVectorType val { QWavVectorType(32767 * (b ? 1 : -1)) };
-                    for (size_t c { 0 }; c < wavlen; ++c) {
-                        v[wavpos++] = val;
-                    }
-                }
-            }
-        }
+    //Blocks are rendered in parallel by groups, so the progress is reported and the cancellation is checked between them
+    const int groupSize { std::max(1, QThread::idealThreadCount()) * 4 };
+    for (int g { 0 }; g < blocks.size(); g += groupSize) {
+        auto group = blocks.mid(g, groupSize);
+        QtConcurrent::blockingMap(group, renderBlock);
 
-        //Silence
-        threshold = mWavFormatHeader.sampleRate * silence;
-        for (size_t s { 0 }; s < threshold; ++s) {
-            v[wavpos++] = s == 1 ? 0. : -1.;
+        if (progress && !progress(group.last().dataOffset + group.last().dataSize, fSize)) {
+            return Cancelled;
         }
     }
 
-
     for (auto i = 0; i < mWavFormatHeader.numberOfChannels; ++i) {
         auto& ch = i == 0 ? mChannel0 : mChannel1;
         ch.reset(new QWavVector(v));
     }
 
-    WaveFormModel::instance()->initialize({ getChannel0(), getChannel1() });
     mWavOpened = true;
+    return Ok;
 }
 
 void WavReader::saveWaveform(const QString& fname) const
 {
     QFile f(fname.isEmpty() ? QString("waveform_%1.wfm").arg(QDateTime::currentDateTime().toString("dd.MM.yyyy hh-mm-ss.zzz")) : fname);
-    f.open(QIODevice::ReadWrite);
+    if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "Unable to open waveform file for writing: " << f.errorString();
+        return;
+    }
+
+    const auto s = SuspiciousPointsModel::instance()->getSuspiciousPoints();
+    QVector<QSharedPointer<QWavVector>> channels;
+    for (auto i = 0; i < mWavFormatHeader.numberOfChannels; ++i) {
+        const auto ch { i == 0 ? getChannel0() : getChannel1() };
+        if (!ch.isNull()) {
+            channels.append(ch);
+        }
+    }
+
+    //Build the table of contents, every section starts from the page bound
+    WfmHeader header { wfmId, wfmVersion, static_cast<uint16_t>(channels.size() + 1), mWavFormatHeader };
+    QVector<WfmSection> sections;
+    QVector<QByteArray> coded(channels.size());
+    uint64_t offset { alignWfmOffset(sizeof(WfmHeader) + header.sectionsCount * sizeof(WfmSection), wfmSectionAlignment) };
+    for (auto i = 0; i < channels.size(); ++i) {
+        const auto& ch { *channels.at(i) };
+        //Channel is stored raw if compression is disabled or the channel can't be coded losslessly
+        if (mWaveformCompression) {
+            coded[i] = WaveformCodec::encode(ch);
+        }
+        const auto codec { coded.at(i).isEmpty() ? WaveformCodec::NoCodec : WaveformCodec::PredictiveRiceCodec };
+        const uint64_t size { codec == WaveformCodec::NoCodec
+                    ? ch.visit([](const auto& samples) { return static_cast<uint64_t>(samples.size()) * sizeof(samples[0]); })
+                    : static_cast<uint64_t>(coded.at(i).size()) };
+        sections.append(WfmSection { i == 0 ? wfmChannel0Id : wfmChannel1Id, static_cast<uint16_t>(ch.sampleType()), codec, offset, size });
+        offset = alignWfmOffset(offset + size, wfmSectionAlignment);
+    }
+    sections.append(WfmSection { wfmSuspiciousPointsId, 0, WaveformCodec::NoCodec, offset, s.size() * sizeof(uint64_t) });
 
-    //Store header
     QByteArray b;
-    appendData(b, mWavFormatHeader);
+    appendData(b, header);
+    for (const auto& section: sections) {
+        appendData(b, section);
+    }
+    f.write(b);
 
-    for (auto i = 0; i < mWavFormatHeader.numberOfChannels; ++i) {
-        const auto& ch = i == 0 ? *getChannel0() : *getChannel1();
-        //Store channel length
-        const int32_t l = ch.length();
-        appendData(b, l);
-        //Store channel
-        for (const auto& v: ch) {
-            appendData(b, v);
+    //Raw channels are written straight from their storage, padding up to the section offset is filled with zeros
+    for (auto i = 0; i < channels.size(); ++i) {
+        f.write(QByteArray(sections.at(i).offset - f.pos(), '\0'));
+        if (sections.at(i).codec != WaveformCodec::NoCodec) {
+            f.write(coded.at(i));
+            continue;
         }
+        channels.at(i)->visit([&f](const auto& samples) {
+            f.write(reinterpret_cast<const char*>(samples.constData()), static_cast<qint64>(samples.size()) * sizeof(samples[0]));
+        });
     }
 
     //Store suspicious points
-    const auto s = SuspiciousPointsModel::instance()->getSuspiciousPoints();
-    const int32_t l = s.length();
-    appendData(b, l);
+    b.clear();
+    b.append(sections.last().offset - f.pos(), '\0');
     for (const auto& p: s) {
-        uint32_t sp = p.toUInt();
+        const uint64_t sp = p.toULongLong();
         appendData(b, sp);
     }
 
@@ -421,9 +790,12 @@ void WavReader::shiftWaveform(uint chNum)
     auto& storedCh = mStoredChannels[chNum];
     auto& ch = chNum == 0 ? mChannel0 : mChannel1;
     storedCh.reset(new QWavVector(*ch.get()));
-    for (auto i = 0; i < mChannel0->size(); ++i) {
-        ch->operator[](i) -= 1300;
-    }
+    ch->visit([](auto& samples) {
+        using T = typename std::decay_t<decltype(samples)>::value_type;
+        for (auto& s: samples) {
+            s = QWavVector::sampleCast<T>(s - 1300.);
+        }
+    });
 }
 
 void WavReader::storeWaveform(uint chNum)
@@ -459,41 +831,45 @@ void WavReader::repairWaveform(uint chNum) {
         return;
     }
 
-    auto& ch = *(chNum == 0 ? mChannel0 : mChannel1).get();
-    auto& ch2 =  *(chNum == 0 ? mChannel1 : mChannel0).get();
-    const auto size { ch.size() };
-    const auto size2 { ch2.size() };
-    if (size == 0) {
-        qDebug() << "Empty channel data";
+    auto& channel = *(chNum == 0 ? mChannel0 : mChannel1).get();
+    const auto& channel2 = *(chNum == 0 ? mChannel1 : mChannel0).get();
+    channel.visit([&channel2](auto& ch) {
+        using T = typename std::decay_t<decltype(ch)>::value_type;
+        //Both channels of the file are stored with the same sample type
+        const auto& ch2 = channel2.as<T>();
+        const auto size { ch.size() };
+        const auto size2 { ch2.size() };
+        if (size == 0) {
+            qDebug() << "Empty channel data";
+            return;
+        }
+        for (auto i = 0; i < size; ++i) {
+            const auto u = i < size2 ? (ch[i] + ch2[i]) / 2 : ch[i];
+            ch[i] = u;
+        }
         return;
-    }
-    for (auto i = 0; i < size; ++i) {
-        const auto u = i < size2 ? (ch[i] + ch2[i]) / 2 : ch[i];
-        ch[i] = u;
-    }
-    return;
-
-    auto siz1 { ch.size() };
-
-    int    du,siz0,_siz0;		// last amplitude value, size of last buff
-    int a0,u0,du0;				// peak (index,amplitude,delta)
-    int a1,u1,du1;				// peak (index,amplitude,delta)
-    int a2,u2,du2;				// peak (index,amplitude,delta)
-
-    du=0x7FFFFFFF; siz0=0; _siz0=siz1;
-    a0=0; u0=0x7FFFFFFF; du0=0;
-    a1=0; u1=0x7FFFFFFF; du1=0;
-    a2=0; u2=0x7FFFFFFF; du2=0;
-
-    int64_t adr,/*i,*/u,thr,A0,A1,U0,U1,uu;
-    //                        noise      amplitude
-    //                      threshold  min        max
-    //if (wav.fmt.bits== 8){ thr=  32; U0=     0; U1=   255; }
-    { thr=6000; U0=-30000; U1=+30000; }
-    /*
-    for (adr=0;adr<siz1;++adr)
-        {
-        // sum chanels into mono
+
+        auto siz1 { ch.size() };
+
+        int    du,siz0,_siz0;		// last amplitude value, size of last buff
+        int a0,u0,du0;				// peak (index,amplitude,delta)
+        int a1,u1,du1;				// peak (index,amplitude,delta)
+        int a2,u2,du2;				// peak (index,amplitude,delta)
+
+        du=0x7FFFFFFF; siz0=0; _siz0=siz1;
+        a0=0; u0=0x7FFFFFFF; du0=0;
+        a1=0; u1=0x7FFFFFFF; du1=0;
+        a2=0; u2=0x7FFFFFFF; du2=0;
+
+        int64_t adr,/*i,*/u,thr,A0,A1,U0,U1,uu;
+        //                        noise      amplitude
+        //                      threshold  min        max
+        //if (wav.fmt.bits== 8){ thr=  32; U0=     0; U1=   255; }
+        { thr=6000; U0=-30000; U1=+30000; }
+        /*
+        for (adr=0;adr<siz1;++adr)
+            {
+            // sum chanels into mono
 //        for (u=0,i=0;i<wav.fmt.chanels;i++)
 //            {
 //            if (wav.fmt.bits== 8) u+=((unsigned __int8* )(dat1+adr))[i];
@@ -505,22 +881,22 @@ void WavReader::repairWaveform(uint chNum) {
 //            if (wav.fmt.bits== 8) ((unsigned __int8* )(dat1+adr))[i]=u;
 //            if (wav.fmt.bits==16) ((         __int16*)(dat1+adr))[i]=u;
 //            }
-        u = adr < size2 ? (ch.at(adr) + ch2.at(adr)) / 2 : ch.at(adr);
-        // detect peaks
-        if (du==0x7FFFFFFF) du=u; 					// first value
-        if (u2==0x7FFFFFFF){ a2=adr; u2=u; du2=0; }	// first value
-        du=u-du;									// delta
-        if (du*du2>=0) du2+=du;						// no peak
-        else{
-            if ((abs(du1)>thr)&&(abs(du2)>thr))		// 2 valid peaks
-                {
-                uu=u;
-                // center and normalize amplitude
-                if (u1<u2){ A0=u1; A1=u2; }
-                 else     { A0=u2; A1=u1; }
-                if (A1-A0>thr)
-                 for (;a1<a2;++a1)
+            u = adr < size2 ? (ch.at(adr) + ch2.at(adr)) / 2 : ch.at(adr);
+            // detect peaks
+            if (du==0x7FFFFFFF) du=u; 					// first value
+            if (u2==0x7FFFFFFF){ a2=adr; u2=u; du2=0; }	// first value
+            du=u-du;									// delta
+            if (du*du2>=0) du2+=du;						// no peak
+            else{
+                if ((abs(du1)>thr)&&(abs(du2)>thr))		// 2 valid peaks
                     {
+                    uu=u;
+                    // center and normalize amplitude
+                    if (u1<u2){ A0=u1; A1=u2; }
+                     else     { A0=u2; A1=u1; }
+                    if (A1-A0>thr)
+                     for (;a1<a2;++a1)
+                        {
 //                    for (u=0,i=0;i<wav.fmt.chanels;i++)
 //                        {
 //                        if (a1<0)
@@ -533,11 +909,11 @@ void WavReader::repairWaveform(uint chNum) {
 //                            if (wav.fmt.bits==16) u+=((         __int16*)(dat1+a1))[i];
 //                            }
 //                        } u/=i;
-                    u = ch.at(a1);
-                    u=U0+(((U1-U0)*(u-A0))/(A1-A0));
-                    if (u<U0) u=U0;
-                    if (u>U1) u=U1;
-                    ch[a1] = u;
+                        u = ch.at(a1);
+                        u=U0+(((U1-U0)*(u-A0))/(A1-A0));
+                        if (u<U0) u=U0;
+                        if (u>U1) u=U1;
+                        ch[a1] = u;
 //                    for (i=0;i<wav.fmt.chanels;i++)
 //                        {
 //                        if (a1<0)
@@ -550,68 +926,68 @@ void WavReader::repairWaveform(uint chNum) {
 //                            if (wav.fmt.bits==16) ((         __int16*)(dat1+a1))[i]=u;
 //                            }
 //                        }
+                        }
+                    // shift peaks forward
+                    a0=a1;  u0=u1; du0=du1;
+                    a1=a2;  u1=u2; du1=du2;
+                    a2=adr; u2=uu; du2=du; u=uu;
+                    }
+                else if (u1==0x7FFFFFFF)					// first peak
+                    {
+                    // shift peaks forward
+                    a0=a1;  u0=u1; du0=du1;
+                    a1=a2;  u1=u2; du1=du2;
+                    a2=adr; u2=u;  du2=du;
+                    }
+                else{										// noise
+                    // shift peaks backward
+                    a2=a1; u2=u1; du2=u-u2;
+                    a1=a0; u1=u0; du1=du0;
+                    a0= 0; u0=0x7FFFFFFF; du0=0;
                     }
-                // shift peaks forward
-                a0=a1;  u0=u1; du0=du1;
-                a1=a2;  u1=u2; du1=du2;
-                a2=adr; u2=uu; du2=du; u=uu;
-                }
-            else if (u1==0x7FFFFFFF)					// first peak
-                {
-                // shift peaks forward
-                a0=a1;  u0=u1; du0=du1;
-                a1=a2;  u1=u2; du1=du2;
-                a2=adr; u2=u;  du2=du;
-                }
-            else{										// noise
-                // shift peaks backward
-                a2=a1; u2=u1; du2=u-u2;
-                a1=a0; u1=u0; du1=du0;
-                a0= 0; u0=0x7FFFFFFF; du0=0;
                 }
+            du=u;
             }
-        du=u;
-        }
 //    if ((a0>=0)&&(u0!=0x7FFFFFFF)) a0-=siz1;
 //    if ((a1>=0)&&(u1!=0x7FFFFFFF)) a1-=siz1;
 //    if ((a2>=0)&&(u2!=0x7FFFFFFF)) a2-=siz1;
 //    siz0=_siz0;	_siz0=siz1;
-*/
-    const auto thrhold = thr;
-    auto v { ch.first() };
-    auto max { v };
-    //auto it { ch.begin() };
-    auto i { size - size };
-    while (i < size) {
-        v = ch[i];
+    */
+        const auto thrhold = thr;
+        auto v { ch.first() };
+        auto max { v };
+        //auto it { ch.begin() };
+        auto i { size - size };
         while (i < size) {
-        //auto tit = std::find_if(it, ch.end(), [&max, v, threshold](auto& val) {
-            auto& val = ch[i];
-                bool signEqual { lessThanZero(v) == lessThanZero(val) };
-                if (signEqual) {
-                    if (abs(val) > abs(max)) {
-                        max = val;
+            v = ch[i];
+            while (i < size) {
+            //auto tit = std::find_if(it, ch.end(), [&max, v, threshold](auto& val) {
+                auto& val = ch[i];
+                    bool signEqual { lessThanZero(v) == lessThanZero(val) };
+                    if (signEqual) {
+                        if (abs(val) > abs(max)) {
+                            max = val;
+                        }
+                    } else if (abs(val) <= abs(thrhold)) {
+                        //if (i >= 553180) {
+                            val = (max + val) / 2;
+                            signEqual = lessThanZero(v) == lessThanZero(val);
+                        //}
                     }
-                } else if (abs(val) <= abs(thrhold)) {
-                    //if (i >= 553180) {
-                        val = (max + val) / 2;
-                        signEqual = lessThanZero(v) == lessThanZero(val);
-                    //}
-                }
-                if (!signEqual) {
-                    break;
-                }
+                    if (!signEqual) {
+                        break;
+                    }
+                    ++i;
+                //});
+            }
+            if (i < size) {
+                max = ch.at(i);
                 ++i;
-            //});
-        }
-        if (i < size) {
-            max = ch.at(i);
-            ++i;
-        }
+            }
 //        uint64_t d = std::distance(it, ch.end());
 //        qDebug() << "Distance: " << d;
-    }
-
+        }
+    });
 }
 
 void WavReader::normalizeWaveform(uint chNum)
@@ -621,70 +997,73 @@ void WavReader::normalizeWaveform(uint chNum)
         return;
     }
 
-    auto& ch = *(chNum == 0 ? mChannel0 : mChannel1).get();
-    auto haveSameSign = [](QWavVectorType o1, QWavVectorType o2) {
-        return lessThanZero(o1) == lessThanZero(o2);
-    };
+    auto& channel = *(chNum == 0 ? mChannel0 : mChannel1).get();
+    channel.visit([&](auto& ch) {
+        using T = typename std::decay_t<decltype(ch)>::value_type;
+        auto haveSameSign = [](T o1, T o2) {
+            return lessThanZero(o1) == lessThanZero(o2);
+        };
 
-    //Trying to find a sine
-    auto bIt = ch.begin();
+        //Trying to find a sine
+        auto bIt = ch.begin();
 
-    while (bIt != ch.end()) {
-        //qDebug() << "bIt: " << std::distance(ch.begin(), bIt) << "; end: " << std::distance(ch.begin(), ch.end());
+        while (bIt != ch.end()) {
+            //qDebug() << "bIt: " << std::distance(ch.begin(), bIt) << "; end: " << std::distance(ch.begin(), ch.end());
 //        auto itPos = std::distance(ch.begin(), bIt);
 //        auto prc = ((float) itPos / ch.size()) * 100;
 //        qDebug() << "Total: " << (int) prc;
 
-        auto prevIt = bIt;
-        auto it = std::next(prevIt);
-        QMap<int, QVector<QWavVectorType>::iterator> peaks {{0, bIt}};
-
-        for (int i = 1; i < 4; ++i) {
-            //down-to-up part when i == 1, 3
-            //up-to-down part when i == 2
-            bool finished = true;
-            for (; it != ch.end();) {
-                if (haveSameSign(*prevIt, *it)) {
-                    if ((i == 2 ? std::abs(*prevIt) >= std::abs(*it) : std::abs(*prevIt) <= std::abs(*it))) {
-                        prevIt = it;
-                        it = std::next(it);
+            auto prevIt = bIt;
+            auto it = std::next(prevIt);
+            QMap<int, typename QVector<T>::iterator> peaks {{0, bIt}};
+
+            for (int i = 1; i < 4; ++i) {
+                //down-to-up part when i == 1, 3
+                //up-to-down part when i == 2
+                bool finished = true;
+                for (; it != ch.end();) {
+                    if (haveSameSign(*prevIt, *it)) {
+                        if ((i == 2 ? std::abs(*prevIt) >= std::abs(*it) : std::abs(*prevIt) <= std::abs(*it))) {
+                            prevIt = it;
+                            it = std::next(it);
+                        }
+                        else {
+                            peaks[i] = it;
+                            break;
+                        }
                     }
                     else {
-                        peaks[i] = it;
-                        break;
+                        bIt = it;
+                        finished = false;
+                        it = ch.end();
                     }
                 }
-                else {
-                    bIt = it;
-                    finished = false;
-                    it = ch.end();
-                }
-            }
 
-            //Signal crosses zero level - not ours case
-            if (it == ch.end()) {
-                if (finished) {
-                    bIt = it;
+                //Signal crosses zero level - not ours case
+                if (it == ch.end()) {
+                    if (finished) {
+                        bIt = it;
+                    }
+                    break;
                 }
-                break;
             }
-        }
 
-        //Looks like we've found a sine, normalizing it
-        if (it != ch.end()) {
-            bIt = it;
-            for (auto i = 0; i < 3; ++i) {
-                auto middlePoint = std::distance(peaks[i], peaks[i + 1]) / 2;
-                auto middleIt = std::next(peaks[i], middlePoint);
-                auto middleVal = *middleIt;
-                auto incVal = QWavVectorType(-1) * middleVal;
-                std::for_each(i == 1 ? middleIt : peaks[i], i == 1 ? peaks[i + 1] : middleIt, [incVal](QWavVectorType& i) {
+            //Looks like we've found a sine, normalizing it
+            if (it != ch.end()) {
+                bIt = it;
+                for (auto i = 0; i < 3; ++i) {
+                    auto middlePoint = std::distance(peaks[i], peaks[i + 1]) / 2;
+                    auto middleIt = std::next(peaks[i], middlePoint);
+                    auto middleVal = *middleIt;
+                    auto incVal = QWavVectorType(-1) * middleVal;
+                    std::for_each(i == 1 ? middleIt : peaks[i], i == 1 ? peaks[i + 1] : middleIt, [incVal](T& i) {
 //                    qDebug() << "Old: " << i << "; new: " << (i+incVal);
-                    i += incVal;
-                });
+                        i = QWavVector::sampleCast<T>(i + incVal);
+                    });
+                }
             }
         }
-    }
+    });
 }
 
 void WavReader::normalizeWaveform2(uint chNum)
@@ -694,69 +1073,69 @@ void WavReader::normalizeWaveform2(uint chNum)
         return;
     }
 
-    auto& ch = *(chNum == 0 ? mChannel0 : mChannel1).get();
-    auto haveSameSign = [](QWavVectorType o1, QWavVectorType o2) {
-        return lessThanZero(o1) == lessThanZero(o2);
-    };
-
-    const auto& parserSettings = ParserSettingsModel::instance()->getParserSettings();
-
-    //Trying to find a sine
-    auto bIt = ch.begin();
-
-    while (bIt != ch.end()) {
-        auto prevIt = bIt;
-        auto it = std::next(prevIt);
-        QMap<int, QVector<QWavVectorType>::iterator> peaks {{0, bIt}};
-
-        for (int i = 1; i < 4; ++i) {
-            //down-to-up part when i == 1, 3
-            //up-to-down part when i == 2
-            bool finished = true;
-            for (; it != ch.end();) {
-                if (haveSameSign(*prevIt, *it)) {
-                    if ((i == 2 ? std::abs(*prevIt) >= std::abs(*it) : std::abs(*prevIt) <= std::abs(*it))) {
-                        prevIt = it;
-                        it = std::next(it);
-                    }
-                    else {
-                        auto itNext = std::next(it);
-                        if (itNext != ch.end() && ((i == 2 ? std::abs(*prevIt) >= std::abs(*itNext) : std::abs(*prevIt) <= std::abs(*itNext)))) {
+    auto& channel = *(chNum == 0 ? mChannel0 : mChannel1).get();
+    channel.visit([&](auto& ch) {
+        using T = typename std::decay_t<decltype(ch)>::value_type;
+        auto haveSameSign = [](T o1, T o2) {
+            return lessThanZero(o1) == lessThanZero(o2);
+        };
+
+            //Trying to find a sine
+        auto bIt = ch.begin();
+
+        while (bIt != ch.end()) {
+            auto prevIt = bIt;
+            auto it = std::next(prevIt);
+            QMap<int, typename QVector<T>::iterator> peaks {{0, bIt}};
+
+            for (int i = 1; i < 4; ++i) {
+                //down-to-up part when i == 1, 3
+                //up-to-down part when i == 2
+                bool finished = true;
+                for (; it != ch.end();) {
+                    if (haveSameSign(*prevIt, *it)) {
+                        if ((i == 2 ? std::abs(*prevIt) >= std::abs(*it) : std::abs(*prevIt) <= std::abs(*it))) {
                             prevIt = it;
-                            it = itNext;
+                            it = std::next(it);
                         }
                         else {
-                            peaks[i] = it;
-                            break;
+                            auto itNext = std::next(it);
+                            if (itNext != ch.end() && ((i == 2 ? std::abs(*prevIt) >= std::abs(*itNext) : std::abs(*prevIt) <= std::abs(*itNext)))) {
+                                prevIt = it;
+                                it = itNext;
+                            }
+                            else {
+                                peaks[i] = it;
+                                break;
+                            }
                         }
                     }
+                    else {
+                        bIt = it;
+                        finished = false;
+                        it = ch.end();
+                    }
                 }
-                else {
-                    bIt = it;
-                    finished = false;
-                    it = ch.end();
-                }
-            }
 
-            //Signal crosses zero level - not ours case
-            if (it == ch.end()) {
-                if (finished) {
-                    bIt = it;
+                //Signal crosses zero level - not ours case
+                if (it == ch.end()) {
+                    if (finished) {
+                        bIt = it;
+                    }
+                    break;
                 }
-                break;
             }
-        }
 
-        //Looks like we've found a sine, normalizing it
-        if (it != ch.end()) {
-            bIt = it;
-            double freq = getSampleRate() / std::distance(peaks[0], peaks[3]);
-            if (freq <= parserSettings.zeroHalfFreq) {
-                auto it = peaks[2];
-                for (int i = 0; i < 2 && it != ch.end(); ++i, ++it) {
-                    auto val = *it;
-                    *it = val >= 0 ? -1000 : 1000;
-                }
+            //Looks like we've found a sine, normalizing it
+            if (it != ch.end()) {
+                bIt = it;
+                double freq = getSampleRate() / std::distance(peaks[0], peaks[3]);
+                if (freq <= parserSettings.zeroHalfFreq) {
+                    auto it = peaks[2];
+                    for (int i = 0; i < 2 && it != ch.end(); ++i, ++it) {
+                        auto val = *it;
+                        *it = val >= 0 ? -1000 : 1000;
+                    }
 //                for (auto i = 0; i < 3; ++i) {
 //                    auto middlePoint = std::distance(peaks[i], peaks[i + 1]) / 2;
 //                    auto middleIt = std::next(peaks[i], middlePoint);
@@ -767,9 +1146,36 @@ void WavReader::normalizeWaveform2(uint chNum)
 //                        i += incVal;
 //                    });
 //                }
+                }
             }
         }
+    });
+}
+
+void WavReader::publishChannels()
+{
+    WaveFormModel::instance()->initialize({ getChannel0(), getChannel1() });
+    emit numberOfChannelsChanged();
+}
+
+void WavReader::adopt(WavReader& other)
+{
+    close();
+    mWavFormatHeader = other.mWavFormatHeader;
+    mDataOffset = other.mDataOffset;
+    mDataSize = other.mDataSize;
+    mChannel0 = other.mChannel0;
+    mChannel1 = other.mChannel1;
+
+    //File can't be handed over between QFile objects, so the opened WAV file is opened again to keep the streaming possible
+    if (other.mWavFile.isOpen()) {
+        mWavFile.setFileName(other.mWavFile.fileName());
+        if (!mWavFile.open(QIODevice::ReadOnly)) {
+            qDebug() << "Unable to reopen WAV file: " << mWavFile.errorString();
+        }
     }
+    mWavOpened = other.mWavOpened;
+    other.close();
 }
 
 WavReader::~WavReader()
@@ -784,3 +1190,8 @@ WavReader* WavReader::instance()
     static QScopedPointer<WavReader> w { new WavReader() };
     return w.get();
 }
+
+WavReader* WavReader::createDetached()
+{
+    return new WavReader();
+}
@@ -18,23 +18,28 @@
 #include <QFile>
 #include <QMap>
 #include <QSharedPointer>
-#include "sources/defines.h"
+#include <functional>
+#include "sources/core/wavvector.h"
+#include "sources/models/parsersettingsmodel.h"
 
 class WavReader : public QObject
 {
     Q_OBJECT
 
     Q_PROPERTY(uint numberOfChannels READ getNumberOfChannels NOTIFY numberOfChannelsChanged)
+    Q_PROPERTY(LoadingMode loadingMode READ getLoadingMode WRITE setLoadingMode NOTIFY loadingModeChanged)
+    Q_PROPERTY(bool waveformCompression READ getWaveformCompression WRITE setWaveformCompression NOTIFY waveformCompressionChanged)
+
+public:
+    enum LoadingMode {
+        BufferedLoading,    //Read the whole data chunk into the intermediate buffer
+        MemoryMappedLoading //Decode samples straight from the memory-mapped file
+    };
+    Q_ENUM(LoadingMode)
 
 private:
 //Disable struct alignment
 #pragma pack(push, 1)
-    struct Int24 {
-        uint8_t b0;
-        uint8_t b1;
-        uint8_t b2;
-    };
-
     struct WavChunk
     {
         uint32_t chunkId;
@@ -47,6 +52,16 @@ private:
         uint32_t riffType;
     };
 
+    //RF64 extension, holds 64-bit sizes of the chunks which have 0xFFFFFFFF size in their headers
+    struct WavDs64
+    {
+        WavChunk chunk;
+        uint64_t riffSize;
+        uint64_t dataSize;
+        uint64_t sampleCount;
+        uint32_t tableLength;
+    };
+
     struct WavFmt
     {
         WavChunk chunk;
@@ -58,6 +73,24 @@ private:
         uint16_t significantBitsPerSample;
     };
 
+    //Waveform project file (.wfm) v2 header, followed by the table of contents of `sectionsCount` sections
+    struct WfmHeader
+    {
+        uint32_t fileId;
+        uint16_t version;
+        uint16_t sectionsCount;
+        WavFmt format;
+    };
+
+    struct WfmSection
+    {
+        uint32_t sectionId;
+        uint16_t sampleType; //QWavVector::SampleType, channel sections only
+        uint16_t codec;      //WaveformCodec::Codec, channel sections only
+        uint64_t offset;
+        uint64_t size;
+    };
+
     template <typename T>
     struct WavMonoSample
     {
@@ -73,19 +106,34 @@ private:
 #pragma pack(pop)
 
     const uint32_t riffId = 0x46464952; //"RIFF"
+    const uint32_t rf64Id = 0x34364652; //"RF64"
+    const uint32_t ds64Id = 0x34367364; //"ds64"
     const uint32_t waveId = 0x45564157; //"WAVE"
     const uint32_t fmt_Id = 0x20746D66; //"fmt "
     const uint32_t dataId = 0x61746164; //"data"
 
+    const uint32_t wfmId = 0x4657585A;         //"ZXWF"
+    const uint32_t wfmChannel0Id = 0x20304843; //"CH0 "
+    const uint32_t wfmChannel1Id = 0x20314843; //"CH1 "
+    const uint32_t wfmSuspiciousPointsId = 0x50535553; //"SUSP"
+    const uint16_t wfmVersion = 2;
+    //Sections are aligned to the page size, so every section may be mapped separately
+    const uint64_t wfmSectionAlignment = 4096;
+
     template <typename T>
-    const T* readData(QByteArray& buf) {
-        buf = mWavFile.read(sizeof(T));
+    const T* readData(QByteArray& buf, QIODevice& device) const {
+        buf = device.read(sizeof(T));
         if ((unsigned) buf.size() < sizeof(T)) {
             return nullptr;
         }
         return reinterpret_cast<const T*>(buf.data());
     }
 
+    template <typename T>
+    const T* readData(QByteArray& buf) {
+        return readData<T>(buf, mWavFile);
+    }
+
     template <typename T>
     T* getData(QByteArray& buf, size_t& bufIndex) const {
         T* res = reinterpret_cast<T*>(buf.data() + bufIndex);
@@ -108,14 +156,18 @@ private:
         return t;
     }
 
-    QWavVectorType getSample(QByteArray& buf, size_t& bufIndex, uint dataSize, uint compressionCode) const;
+    bool seekToChunk(uint32_t chunkId);
     QWavVector* createVector(size_t bytesPerSample, size_t size);
+    bool decodeChannels(const uint8_t* data, size_t frames, QWavVector& ch0, QWavVector* ch1, size_t offset = 0) const;
     unsigned calculateOnesInByte(uint8_t n);
 
     WavFmt mWavFormatHeader;
-    WavChunk mCurrentChunk;
+    uint64_t mDataOffset; //File position of the data chunk samples
+    uint64_t mDataSize;
     bool mWavOpened;
     QFile mWavFile;
+    LoadingMode mLoadingMode;
+    bool mWaveformCompression;
     QSharedPointer<QWavVector> mChannel0;
     QSharedPointer<QWavVector> mChannel1;
     QMap<uint, QSharedPointer<QWavVector>> mStoredChannels;
@@ -132,25 +184,47 @@ public:
         InvalidWavFormat,
         UnsupportedWavFormat,
         InsufficientData,
-        EndOfBuffer
+        EndOfBuffer,
+        DataTooLarge,
+        Cancelled
     };
     Q_ENUM(ErrorCodesEnum)
 
+    //Receives the decoded window of `frames` samples per channel, `ch1` is empty for mono sources.
+    //Window buffers are reused, so only the first `frames` samples are valid. Returning false stops the streaming.
+    using StreamConsumer = std::function<bool(const QWavVector& ch0, const QWavVector& ch1, size_t frames)>;
+    static constexpr const size_t defaultStreamWindowFrames = 1024 * 1024;
+
+    //Receives the number of processed and total bytes of the file being loaded. Returning false cancels the loading.
+    //May be called from the worker thread, so it shouldn't touch the GUI objects directly.
+    using ProgressCallback = std::function<bool(uint64_t processed, uint64_t total)>;
+
     virtual ~WavReader() override;
 
     uint getNumberOfChannels() const;
     uint32_t getSampleRate() const;
     uint getBytesPerSample() const;
+    uint64_t getNumberOfFrames() const;
     QSharedPointer<QWavVector> getChannel0() const;
     QSharedPointer<QWavVector> getChannel1() const;
+    LoadingMode getLoadingMode() const;
+    bool getWaveformCompression() const;
+
+    void setLoadingMode(LoadingMode mode);
+    void setWaveformCompression(bool compression);
 
     ErrorCodesEnum setFileName(const QString& fileName);
     ErrorCodesEnum open();
-    ErrorCodesEnum read();
+    ErrorCodesEnum read(const ProgressCallback& progress = ProgressCallback());
+    ErrorCodesEnum readStreamed(const StreamConsumer& consumer, size_t windowFrames = defaultStreamWindowFrames);
     ErrorCodesEnum close();
 
-    void loadTap(const QString& fname);
-    void loadWaveform(const QString& fname);
+    //Settings are passed by value, so the file may be loaded by the worker thread while the settings are changed in GUI
+    ErrorCodesEnum loadTap(const QString& fname, const ParserSettingsModel::ParserSettings& parserSettings, const ProgressCallback& progress = ProgressCallback());
+    ErrorCodesEnum loadWaveform(const QString& fname, const ProgressCallback& progress = ProgressCallback());
+    void publishChannels();
+    //Takes over the loaded data and channels of the other reader, which is closed then
+    void adopt(WavReader& other);
     void saveWaveform(const QString& fname = QString()) const;
     void shiftWaveform(uint chNum);
     void storeWaveform(uint chNum);
@@ -160,9 +234,17 @@ public:
     void normalizeWaveform2(uint chNum);
 
     static WavReader* instance();
+    //Creates the reader which isn't published, so a file may be loaded aside of the instance and adopted by it when the loading succeeds
+    static WavReader* createDetached();
+
+private:
+    ErrorCodesEnum loadWaveformV1(QFile& f, const ProgressCallback& progress);
+    ErrorCodesEnum loadWaveformV2(QFile& f, const ProgressCallback& progress);
 
 signals:
     void numberOfChannelsChanged();
+    void loadingModeChanged();
+    void waveformCompressionChanged();
 };
 
 #endif // WAVREADER_H
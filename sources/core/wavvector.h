@@ -0,0 +1,130 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#ifndef WAVVECTOR_H
+#define WAVVECTOR_H
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <variant>
+#include <QVector>
+#include "sources/defines.h"
+
+//Channel samples container. Samples are kept in their native type (int16 for 8/16-bit sources, float otherwise).
+//Bulk processing should be done with visit(), which calls the functor with the underlying QVector<T>,
+//per-sample access by at()/set() converts the value to/from QWavVectorType.
+class QWavVector final
+{
+public:
+    enum SampleType {
+        Int16Samples,
+        FloatSamples
+    };
+
+    using size_type = QVector<QWavVectorType>::size_type;
+
+    explicit QWavVector(SampleType type = FloatSamples, size_type size = 0) {
+        if (type == Int16Samples) {
+            m_data.emplace<QVector<int16_t>>(size);
+        } else {
+            m_data.emplace<QVector<float>>(size);
+        }
+    }
+
+    template <typename T>
+    explicit QWavVector(QVector<T> data) :
+        m_data(std::move(data))
+    {
+
+    }
+
+    template <typename T>
+    static T sampleCast(double val) {
+        if constexpr (std::is_integral_v<T>) {
+            return static_cast<T>(std::clamp<double>(std::round(val), std::numeric_limits<T>::min(), std::numeric_limits<T>::max()));
+        } else {
+            return static_cast<T>(val);
+        }
+    }
+
+    SampleType sampleType() const {
+        return std::holds_alternative<QVector<int16_t>>(m_data) ? Int16Samples : FloatSamples;
+    }
+
+    template <typename F>
+    decltype(auto) visit(F&& f) {
+        return std::visit(std::forward<F>(f), m_data);
+    }
+
+    template <typename F>
+    decltype(auto) visit(F&& f) const {
+        return std::visit(std::forward<F>(f), m_data);
+    }
+
+    template <typename T>
+    QVector<T>& as() {
+        return std::get<QVector<T>>(m_data);
+    }
+
+    template <typename T>
+    const QVector<T>& as() const {
+        return std::get<QVector<T>>(m_data);
+    }
+
+    size_type size() const {
+        return visit([](const auto& v) { return v.size(); });
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    QWavVectorType at(size_type i) const {
+        return visit([i](const auto& v) { return static_cast<QWavVectorType>(v.at(i)); });
+    }
+
+    void set(size_type i, QWavVectorType val) {
+        visit([i, val](auto& v) { v[i] = sampleCast<typename std::decay_t<decltype(v)>::value_type>(val); });
+    }
+
+    void insert(size_type i, QWavVectorType val) {
+        visit([i, val](auto& v) { v.insert(i, sampleCast<typename std::decay_t<decltype(v)>::value_type>(val)); });
+    }
+
+    void remove(size_type i) {
+        visit([i](auto& v) { v.remove(i); });
+    }
+
+    //Replaces `count` samples starting from `i` by the values, the following samples are moved once if the number of values differs
+    void replace(size_type i, size_type count, const QVector<QWavVectorType>& values) {
+        visit([i, count, &values](auto& v) {
+            using T = typename std::decay_t<decltype(v)>::value_type;
+            if (values.size() > count) {
+                v.insert(i + count, values.size() - count, T());
+            }
+            else if (values.size() < count) {
+                v.remove(i + values.size(), count - values.size());
+            }
+            for (size_type k = 0; k < values.size(); ++k) {
+                v[i + k] = sampleCast<T>(values[k]);
+            }
+        });
+    }
+
+private:
+    std::variant<QVector<int16_t>, QVector<float>> m_data;
+};
+
+#endif // WAVVECTOR_H
@@ -0,0 +1,123 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#include "zerocrossingdetector.h"
+#include "sources/defines.h"
+#include <type_traits>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define ZEROCROSSINGDETECTOR_X86_SIMD
+#include <immintrin.h>
+#endif
+
+namespace {
+    template <typename T>
+    __attribute__((always_inline)) inline size_t detectTail(const T* data, size_t begin, size_t end, bool negative, uint32_t* crossings, size_t count) {
+        for (size_t i = begin; i < end; ++i) {
+            if (lessThanZero(data[i]) != negative) {
+                crossings[count++] = static_cast<uint32_t>(i);
+                negative = !negative;
+            }
+        }
+        return count;
+    }
+
+#ifndef ZEROCROSSINGDETECTOR_X86_SIMD
+    template <typename T>
+    size_t detectScalar(const T* data, size_t size, bool negative, uint32_t* crossings) {
+        return detectTail(data, 0, size, negative, crossings, 0);
+    }
+#else
+    //Vector kernels build the mask of negative samples of the `Step` samples long block,
+    //sign changes are the bits that differ from the previous ones and are turned into the indexes
+    template <typename T, unsigned Step, typename MaskFunction>
+    __attribute__((always_inline)) inline size_t detectBlocks(const T* data, size_t size, bool negative, uint32_t* crossings, MaskFunction negativeMask) {
+        constexpr const uint64_t blockMask = (uint64_t(1) << Step) - 1;
+        uint64_t prev = negative;
+        size_t count = 0;
+        size_t i = 0;
+        for (; i + Step <= size; i += Step) {
+            const uint64_t mask = negativeMask(data + i);
+            uint64_t changes = (mask ^ ((mask << 1) | prev)) & blockMask;
+            prev = mask >> (Step - 1);
+            while (changes) {
+                crossings[count++] = static_cast<uint32_t>(i + __builtin_ctzll(changes));
+                changes &= changes - 1;
+            }
+        }
+        return detectTail(data, i, size, prev != 0, crossings, count);
+    }
+
+    size_t detectInt16Sse2(const int16_t* data, size_t size, bool negative, uint32_t* crossings) {
+        return detectBlocks<int16_t, 16>(data, size, negative, crossings, [](const int16_t* p) -> uint64_t {
+            //Saturated packing keeps the sign, so every byte of the mask corresponds to one sample
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 8));
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_packs_epi16(a, b)));
+        });
+    }
+
+    __attribute__((target("avx2"))) size_t detectInt16Avx2(const int16_t* data, size_t size, bool negative, uint32_t* crossings) {
+        return detectBlocks<int16_t, 32>(data, size, negative, crossings, [](const int16_t* p) __attribute__((target("avx2"))) -> uint64_t {
+            //Packing is performed inside of 128-bit lanes, so the 64-bit parts have to be reordered afterwards
+            const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+            const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 16));
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(packed));
+        });
+    }
+
+    size_t detectFloatSse2(const float* data, size_t size, bool negative, uint32_t* crossings) {
+        return detectBlocks<float, 16>(data, size, negative, crossings, [](const float* p) -> uint64_t {
+            //Comparison is used instead of the sign bit, so the negative zero isn't treated as negative
+            const __m128 zero = _mm_setzero_ps();
+            return static_cast<uint64_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(p), zero)))
+                 | static_cast<uint64_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(p + 4), zero))) << 4
+                 | static_cast<uint64_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(p + 8), zero))) << 8
+                 | static_cast<uint64_t>(_mm_movemask_ps(_mm_cmplt_ps(_mm_loadu_ps(p + 12), zero))) << 12;
+        });
+    }
+
+    __attribute__((target("avx2"))) size_t detectFloatAvx2(const float* data, size_t size, bool negative, uint32_t* crossings) {
+        return detectBlocks<float, 32>(data, size, negative, crossings, [](const float* p) __attribute__((target("avx2"))) -> uint64_t {
+            const __m256 zero = _mm256_setzero_ps();
+            return static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), zero, _CMP_LT_OQ)))
+                 | static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + 8), zero, _CMP_LT_OQ))) << 8
+                 | static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + 16), zero, _CMP_LT_OQ))) << 16
+                 | static_cast<uint64_t>(_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p + 24), zero, _CMP_LT_OQ))) << 24;
+        });
+    }
+
+    bool isAvx2Supported() {
+        static const bool avx2 = __builtin_cpu_supports("avx2");
+        return avx2;
+    }
+#endif
+}
+
+template <typename T>
+ZeroCrossingDetector::DetectFunction<T> ZeroCrossingDetector::getDetectFunction()
+{
+#ifdef ZEROCROSSINGDETECTOR_X86_SIMD
+    if constexpr (std::is_same_v<T, int16_t>) {
+        return isAvx2Supported() ? &detectInt16Avx2 : &detectInt16Sse2;
+    } else {
+        return isAvx2Supported() ? &detectFloatAvx2 : &detectFloatSse2;
+    }
+#else
+    return &detectScalar<T>;
+#endif
+}
+
+template ZeroCrossingDetector::DetectFunction<float> ZeroCrossingDetector::getDetectFunction<float>();
+template ZeroCrossingDetector::DetectFunction<int16_t> ZeroCrossingDetector::getDetectFunction<int16_t>();
@@ -0,0 +1,36 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+#ifndef ZEROCROSSINGDETECTOR_H
+#define ZEROCROSSINGDETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+
+class ZeroCrossingDetector final
+{
+public:
+    //Stores the indexes of the samples which sign differs from the sign of their preceding samples into `crossings`
+    //and returns the number of stored indexes. `negative` is the sign of the sample preceding the first one.
+    //`crossings` should have room for `size` indexes.
+    template <typename T>
+    using DetectFunction = size_t (*)(const T* data, size_t size, bool negative, uint32_t* crossings);
+
+    ZeroCrossingDetector() = delete;
+
+    //Returns the fastest kernel supported by the CPU
+    template <typename T>
+    static DetectFunction<T> getDetectFunction();
+};
+
+#endif // ZEROCROSSINGDETECTOR_H
@@ -16,8 +16,8 @@
 
 #include <QVector>
 
+//Sample value type used for the per-sample access, channels store the samples in their native type (see QWavVector)
 using QWavVectorType = float;
-using QWavVector = QVector<QWavVectorType>;
 
 template<typename T>
 inline bool lessThanZero(T t) {
@@ -13,6 +13,7 @@
 
 #include <QGuiApplication>
 #include <QQmlApplicationEngine>
+#include "sources/batch/batchprocessor.h"
 #include "sources/controls/waveformcontrol.h"
 #include "sources/core/waveformparser.h"
 #include "sources/models/fileworkermodel.h"
@@ -46,6 +47,12 @@ void registerTypes()
 
 int main(int argc, char *argv[])
 {
+    //Batch mode doesn't create any GUI objects, so it runs on the hosts without display as well
+    if (BatchProcessor::isRequested(argc, argv)) {
+        QCoreApplication app(argc, argv);
+        return BatchProcessor().run(app.arguments());
+    }
+
     QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
 
     QGuiApplication app(argc, argv);
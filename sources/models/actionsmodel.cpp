@@ -13,7 +13,9 @@
 
 #include "actionsmodel.h"
 #include <QVariantMap>
+#include "sources/actions/flipbitsaction.h"
 #include "sources/actions/shiftwaveformaction.h"
+#include "sources/core/waveformparser.h"
 
 ActionsModel::ActionsModel(QObject* parent) :
     QObject(parent)
@@ -39,6 +41,13 @@ void ActionsModel::shiftWaveform(double offset) {
     addAction(QSharedPointer<ShiftWaveFormAction>::create(0, ShiftWaveFormActionParams { static_cast<QWavVectorType>(offset) }));
 }
 
+void ActionsModel::repairBits(int repairIndex) {
+    const auto parser { WaveformParser::instance() };
+    const auto repair { parser->getBitRepair(repairIndex) };
+    if (repair) {
+        addAction(QSharedPointer<FlipBitsAction>::create(parser->getBitRepairsChannel(), FlipBitsActionParams { repair->flips }));
+    }
+}
 
 QVariantList ActionsModel::getActions() const {
     QVariantList result;
@@ -46,6 +46,8 @@ public:
     void addAction(QSharedPointer<ActionBase> action);
     Q_INVOKABLE void removeAction();
     Q_INVOKABLE void shiftWaveform(double offset);
+    //Applies the bit repair found by the waveform parser
+    Q_INVOKABLE void repairBits(int repairIndex);
 
 signals:
     void actionsChanged();
@@ -17,6 +17,7 @@
 DataPlayerModel::DataPlayerModel(QObject* parent) :
     QObject(parent),
     m_playingState(DP_Stopped),
+    m_snapshot(ParsedData::SnapshotPtr::create()),
     m_blockTime(0),
     m_processedTime(0)
 {
@@ -56,13 +57,16 @@ void DataPlayerModel::playParsedData(uint chNum, uint currentBlock) {
 
     m_buffer.close();
     m_currentBlock = currentBlock;
-    m_data = WaveformParser::instance()->getParsedData(chNum);
-    m_parserData = chNum == 0 ? WaveformParser::instance()->getParsedChannel0() : WaveformParser::instance()->getParsedChannel1();
+    //Blocks, their rows and selection are taken at once, so the playing isn't affected by the following parsings
+    m_snapshot = WaveformParser::instance()->getSnapshot(chNum);
+    const auto blocksModel { WaveformParser::instance()->getParsedBlocksModel(chNum) };
+    m_blockRows = blocksModel == nullptr ? QVector<ParsedBlocksModel::Row>() : blocksModel->getRows();
+    m_selection = blocksModel == nullptr ? QVector<bool>() : blocksModel->getSelection();
     handleNextDataRecord();
 }
 
 void DataPlayerModel::handleNextDataRecord() {
-    if (m_currentBlock >= (unsigned) m_data.first.size()) {
+    if (m_currentBlock >= (unsigned) m_snapshot->blocks.size()) {
         return;
     }
 
@@ -104,7 +108,7 @@ void DataPlayerModel::handleNextDataRecord() {
         }
     }
     //Data
-    for (const uint8_t byte: qAsConst(m_data.first[m_currentBlock].data)) {
+    for (const uint8_t byte: qAsConst(m_snapshot->blocks[m_currentBlock].data)) {
         for (int i { 7 }; i >= 0; --i) {
             const uint8_t bit8 = 1 << i;
             const auto bit { byte & bit8 };
@@ -137,8 +141,8 @@ void DataPlayerModel::handleNextDataRecord() {
 }
 
 void DataPlayerModel::prepareNextDataRecord() {
-    const QVector<ParsedData::DataBlock>& blockData { m_data.first };
-    const QVector<bool>& selectionData { m_data.second };
+    const QVector<ParsedData::DataBlock>& blockData { m_snapshot->blocks };
+    const QVector<bool>& selectionData { m_selection };
     while (m_currentBlock < (unsigned) blockData.size()) {
         if ((unsigned) selectionData.size() < m_currentBlock || selectionData.at(m_currentBlock)) {
             break;
@@ -188,7 +192,7 @@ void DataPlayerModel::handleAudioOutputStateChanged(QAudio::State state) {
 
 void DataPlayerModel::stop() {
     if (m_playingState != DP_Stopped) {
-        m_currentBlock = m_data.first.size();
+        m_currentBlock = m_snapshot->blocks.size();
         prepareNextDataRecord();
     }
 }
@@ -203,7 +207,7 @@ bool DataPlayerModel::getStopped() const {
 }
 
 int DataPlayerModel::getCurrentBlock() const {
-    return m_currentBlock < (unsigned) m_data.first.size() ? m_currentBlock : -1;
+    return m_currentBlock < (unsigned) m_snapshot->blocks.size() ? m_currentBlock : -1;
 }
 
 int DataPlayerModel::getBlockTime() const {
@@ -216,7 +220,7 @@ int DataPlayerModel::getProcessedTime() const {
 
 QVariant DataPlayerModel::getBlockData() const {
     const auto cb { getCurrentBlock() };
-    return cb < 0 ? QVariant() : m_parserData.at(cb);
+    return cb < 0 || cb >= m_blockRows.size() ? QVariant() : ParsedBlocksModel::toVariantMap(m_blockRows.at(cb), cb, m_selection.value(cb, true));
 }
 
 DataPlayerModel::~DataPlayerModel() {
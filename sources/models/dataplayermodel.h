@@ -37,8 +37,9 @@ class DataPlayerModel : public QObject
 
     PlayingState m_playingState;
     QScopedPointer<QAudioOutput> m_audio;
-    QPair<QVector<ParsedData::DataBlock>, QVector<bool>> m_data;
-    QVariantList m_parserData;
+    ParsedData::SnapshotPtr m_snapshot;
+    QVector<bool> m_selection;
+    QVector<ParsedBlocksModel::Row> m_blockRows;
     unsigned m_currentBlock;
     QTimer m_delayTimer;
     QBuffer m_buffer;
@@ -15,27 +15,104 @@
 #include "sources/core/waveformparser.h"
 #include <QUrl>
 #include <QDebug>
+#include <QtConcurrent>
 
 FileWorkerModel::FileWorkerModel(QObject* parent) :
     QObject(parent),
-    m_wavFileName(QString())
+    m_wavFileName(QString()),
+    m_loadingWatcher(nullptr),
+    m_loadingReader(nullptr),
+    m_cancelRequested(false),
+    m_loadingProgress(0.)
 {
 
 }
 
+int FileWorkerModel::startLoading(const QString& fileName, const Loader& loader)
+{
+    //Only one file is loaded at a time, so the loading in progress is abandoned
+    if (m_loadingWatcher) {
+        cancelLoading();
+        m_loadingWatcher->waitForFinished();
+        m_loadingWatcher->disconnect(this);
+        m_loadingWatcher->deleteLater();
+        m_loadingWatcher = nullptr;
+    }
+
+    //File is loaded by the detached reader, so the current waveform stays intact and untouched by the worker thread until the new one is loaded
+    const auto& r = *WavReader::instance();
+    m_loadingReader.reset(WavReader::createDetached());
+    m_loadingReader->setLoadingMode(r.getLoadingMode());
+
+    m_cancelRequested = false;
+    setLoadingProgress(0.);
+
+    m_loadingWatcher = new QFutureWatcher<int>(this);
+    connect(m_loadingWatcher, &QFutureWatcher<int>::finished, this, [this, fileName]() {
+        handleLoadingFinished(fileName, m_loadingWatcher->result());
+    });
+    m_loadingWatcher->setFuture(QtConcurrent::run([this, loader, reader = m_loadingReader.data()]() -> int {
+        int lastPercent { 0 };
+        return loader(*reader, [this, &lastPercent](uint64_t processed, uint64_t total) {
+            //Progress is passed to the GUI thread only when it is changed noticeably
+            const int percent = total == 0 ? 100 : static_cast<int>(processed * 100 / total);
+            if (percent != lastPercent) {
+                lastPercent = percent;
+                QMetaObject::invokeMethod(this, [this, percent]() { setLoadingProgress(percent / 100.); }, Qt::QueuedConnection);
+            }
+            return !m_cancelRequested;
+        });
+    }));
+
+    emit loadingChanged();
+    return WavReader::Ok;
+}
+
+void FileWorkerModel::handleLoadingFinished(const QString& fileName, int result)
+{
+    m_loadingWatcher->deleteLater();
+    m_loadingWatcher = nullptr;
+
+    auto& r = *WavReader::instance();
+    //WAV file which can't be decoded into the channels stays opened, so it is parsed by streaming, without showing its waveform
+    const bool streamed { result == WavReader::DataTooLarge && m_loadingReader->getNumberOfChannels() != 0 };
+    if (result == WavReader::Ok || streamed) {
+        //Decoded channels are handed over to the instance and the model all at once in the GUI thread
+        r.adopt(*m_loadingReader);
+        r.publishChannels();
+        if (streamed) {
+            qDebug() << "File is too large to be decoded, it is parsed by streaming:" << fileName;
+            result = WaveformParser::instance()->parseStreamed();
+        }
+        setLoadingProgress(1.);
+        m_wavFileName = fileName;
+        emit wavFileNameChanged();
+    }
+    else {
+        qDebug() << "Unable to load file" << fileName << ":" << static_cast<WavReader::ErrorCodesEnum>(result);
+    }
+    m_loadingReader.reset();
+
+    emit loadingChanged();
+    emit fileLoaded(result);
+}
+
+void FileWorkerModel::cancelLoading()
+{
+    m_cancelRequested = true;
+}
+
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::openTapFileByUrl(const QString& fileNameUrl) {
     QUrl u(fileNameUrl);
     return openTapFile(u.toLocalFile());
 }
 
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::openTapFile(const QString& fileName) {
-    auto& r = *WavReader::instance();
-    r.close();
-
-    r.loadTap(fileName);
-    m_wavFileName = fileName;
-    emit wavFileNameChanged();
-    return WavReader::Ok;
+    //Settings are copied in the GUI thread, the worker doesn't touch the model which may be changed meanwhile
+    const auto parserSettings { ParserSettingsModel::instance()->getParserSettings() };
+    return startLoading(fileName, [fileName, parserSettings](WavReader& r, const WavReader::ProgressCallback& progress) {
+        return r.loadTap(fileName, parserSettings, progress);
+    });
 }
 
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::openWavFileByUrl(const QString& fileNameUrl)
@@ -46,20 +123,11 @@ FileWorkerModel::FileWorkerModel(QObject* parent) :
 
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::openWavFile(const QString& fileName)
 {
-    auto& r = *WavReader::instance();
-    r.close();
-
-    auto result = r.setFileName(fileName);
-    result = r.open();
-    if (result == WavReader::Ok) {
-        result = r.read();
-        if (result == WavReader::Ok) {
-            m_wavFileName = fileName;
-            emit wavFileNameChanged();
-        }
-    }
-
-    return result;
+    return startLoading(fileName, [fileName](WavReader& r, const WavReader::ProgressCallback& progress) {
+        auto result = r.setFileName(fileName);
+        result = r.open();
+        return result == WavReader::Ok ? r.read(progress) : result;
+    });
 }
 
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::openWaveformFileByUrl(const QString& fileNameUrl)
@@ -70,13 +138,9 @@ FileWorkerModel::FileWorkerModel(QObject* parent) :
 
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::openWaveformFile(const QString& fileName)
 {
-    auto& r = *WavReader::instance();
-    r.close();
-
-    r.loadWaveform(fileName);
-    m_wavFileName = fileName;
-    emit wavFileNameChanged();
-    return WavReader::Ok;
+    return startLoading(fileName, [fileName](WavReader& r, const WavReader::ProgressCallback& progress) {
+        return r.loadWaveform(fileName, progress);
+    });
 }
 
 /*WavReader::ErrorCodesEnum*/ int FileWorkerModel::saveWaveformFileByUrl(const QString& fileNameUrl)
@@ -97,7 +161,30 @@ QString FileWorkerModel::getWavFileName() const
     return m_wavFileName;
 }
 
+bool FileWorkerModel::getLoading() const
+{
+    return m_loadingWatcher != nullptr;
+}
+
+double FileWorkerModel::getLoadingProgress() const
+{
+    return m_loadingProgress;
+}
+
+void FileWorkerModel::setLoadingProgress(double progress)
+{
+    if (m_loadingProgress != progress) {
+        m_loadingProgress = progress;
+        emit loadingProgressChanged();
+    }
+}
+
 FileWorkerModel::~FileWorkerModel()
 {
+    //Worker thread refers to the model, so it has to be stopped first
+    if (m_loadingWatcher) {
+        cancelLoading();
+        m_loadingWatcher->waitForFinished();
+    }
     qDebug() << "~FileWorkerModel";
 }
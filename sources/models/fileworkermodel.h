@@ -15,6 +15,9 @@
 #define FILEWORKERMODEL_H
 
 #include <QObject>
+#include <QFutureWatcher>
+#include <QScopedPointer>
+#include <atomic>
 #include "sources/core/wavreader.h"
 
 class FileWorkerModel : public QObject
@@ -22,6 +25,8 @@ class FileWorkerModel : public QObject
     Q_OBJECT
 
     Q_PROPERTY(QString wavFileName READ getWavFileName NOTIFY wavFileNameChanged)
+    Q_PROPERTY(bool loading READ getLoading NOTIFY loadingChanged)
+    Q_PROPERTY(double loadingProgress READ getLoadingProgress NOTIFY loadingProgressChanged)
 
 public:
     enum FileWorkerResults {
@@ -34,10 +39,14 @@ public:
     virtual ~FileWorkerModel() override;
     //getters
     QString getWavFileName() const;
+    bool getLoading() const;
+    double getLoadingProgress() const;
 
     //setters
 
     //QML invokable members
+    //Files are opened by the worker thread, the returned value only tells if the loading is started.
+    //The result of the loading is reported by fileLoaded signal.
     Q_INVOKABLE /*WavReader::ErrorCodesEnum*/ int openTapFileByUrl(const QString& fileNameUrl);
     Q_INVOKABLE /*WavReader::ErrorCodesEnum*/ int openTapFile(const QString& fileName);
     Q_INVOKABLE /*WavReader::ErrorCodesEnum*/ int openWavFileByUrl(const QString& fileNameUrl);
@@ -46,12 +55,26 @@ public:
     Q_INVOKABLE /*WavReader::ErrorCodesEnum*/ int openWaveformFile(const QString& fileName);
     Q_INVOKABLE /*WavReader::ErrorCodesEnum*/ int saveWaveformFileByUrl(const QString& fileNameUrl);
     Q_INVOKABLE /*WavReader::ErrorCodesEnum*/ int saveWaveformFile(const QString& fileName);
+    Q_INVOKABLE void cancelLoading();
 
 signals:
     void wavFileNameChanged();
+    void loadingChanged();
+    void loadingProgressChanged();
+    void fileLoaded(int result);
 
 private:
+    using Loader = std::function<WavReader::ErrorCodesEnum(WavReader& reader, const WavReader::ProgressCallback& progress)>;
+
+    int startLoading(const QString& fileName, const Loader& loader);
+    void handleLoadingFinished(const QString& fileName, int result);
+    void setLoadingProgress(double progress);
+
     QString m_wavFileName;
+    QFutureWatcher<int>* m_loadingWatcher;
+    QScopedPointer<WavReader> m_loadingReader;
+    std::atomic_bool m_cancelRequested;
+    double m_loadingProgress;
 };
 
 #endif // FILEWORKERMODEL_H
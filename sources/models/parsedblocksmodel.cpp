@@ -0,0 +1,203 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#include "parsedblocksmodel.h"
+#include "sources/translations/translationmanager.h"
+#include "sources/translations/translations.h"
+#include <QMap>
+#include <algorithm>
+
+ParsedBlocksModel::ParsedBlocksModel(QObject* parent) :
+    QAbstractListModel(parent),
+    m_snapshot(ParsedData::SnapshotPtr::create())
+{
+    //Row texts are built again in the new language
+    connect(TranslationManager::instance(), &TranslationManager::translationChanged, this, [this]() {
+        buildRows();
+        if (!m_rows.isEmpty()) {
+            emit dataChanged(index(0), index(m_rows.size() - 1));
+        }
+    });
+}
+
+ParsedBlocksModel::Row ParsedBlocksModel::makeRow(const ParsedData::DataBlock& block)
+{
+    static const QMap<int, QString> blockTypes {
+        {0x00, "Program"},
+        {0x01, "Number Array"},
+        {0x02, "Character Array"},
+        {0x03, "Bytes"}
+    };
+
+    Row r;
+    const auto& data { block.data };
+    if (data.isEmpty()) {
+        r.blockType = qtTrId(ID_UNKNOWN);
+        r.blockSize = 0;
+        r.blockStatus = r.blockType;
+        return r;
+    }
+
+    auto d = data.at(0);
+    int blockType = -1;
+    auto btIt = blockTypes.end();
+    if (d == 0x00 && data.size() > 1) {
+        d = data.at(1);
+        btIt = blockTypes.find(d);
+        blockType = btIt == blockTypes.end() ? -1 : d;
+        r.blockType = blockType == -1 ? QString::number(d, 16) : *btIt;
+    }
+    else {
+        blockType = -2;
+        r.blockType = qtTrId(d == 0x00 ? ID_HEADER : ID_CODE);
+    }
+
+    QString sizeText = QString::number(data.size());
+    if (data.size() > 13 && btIt != blockTypes.end()) {
+        sizeText += QString(" (%1)").arg(data.at(13) * 256 + data.at(12));
+    }
+    r.blockSize = sizeText;
+    if (blockType >= 0) {
+        const auto loopRange { std::min(decltype(data.size())(12), data.size()) };
+        r.blockName = QByteArray((const char*) &data.data()[2], loopRange > 1 ? loopRange - 2 : 0);
+    }
+    r.blockStatus = qtTrId(block.state == ParsedData::OK ? ID_OK : ID_ERROR) + qtTrId(ID_PARITY_MESSAGE).arg(QString::number(block.parityCalculated, 16).toUpper().rightJustified(2, '0')).arg(QString::number(block.parityAwaited, 16).toUpper().rightJustified(2, '0'));
+    r.state = block.state;
+    return r;
+}
+
+void ParsedBlocksModel::buildRows()
+{
+    const auto& blocks { m_snapshot->blocks };
+    m_rows.clear();
+    m_rows.reserve(blocks.size());
+    for (const auto& b: blocks) {
+        m_rows.append(makeRow(b));
+    }
+}
+
+int ParsedBlocksModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+QVariant ParsedBlocksModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return { };
+    }
+
+    const auto& r { m_rows.at(index.row()) };
+    switch (role) {
+    case BlockRole:
+        return QVariantMap { {"blockSelected", isSelected(index.row())}, {"blockNumber", index.row()} };
+    case BlockTypeRole:
+        return r.blockType;
+    case BlockNameRole:
+        return r.blockName;
+    case BlockSizeRole:
+        return r.blockSize;
+    case BlockStatusRole:
+        return r.blockStatus;
+    case StateRole:
+        return r.state;
+    default:
+        return { };
+    }
+}
+
+QHash<int, QByteArray> ParsedBlocksModel::roleNames() const
+{
+    return {
+        { BlockRole, "block" },
+        { BlockTypeRole, "blockType" },
+        { BlockNameRole, "blockName" },
+        { BlockSizeRole, "blockSize" },
+        { BlockStatusRole, "blockStatus" },
+        { StateRole, "state" }
+    };
+}
+
+void ParsedBlocksModel::setBlocks(const ParsedData::SnapshotPtr& snapshot)
+{
+    const auto count { m_rows.size() };
+    beginResetModel();
+    m_snapshot = snapshot.isNull() ? ParsedData::SnapshotPtr::create() : snapshot;
+    buildRows();
+    if (m_selection.size() < m_rows.size()) {
+        //Only the blocks which have never been listed are selected, the kept selection of the others isn't touched
+        const auto selected { m_selection.size() };
+        m_selection.resize(m_rows.size());
+        std::fill(m_selection.begin() + selected, m_selection.end(), true);
+    }
+    endResetModel();
+
+    if (count != m_rows.size()) {
+        emit countChanged();
+    }
+}
+
+int ParsedBlocksModel::getCount() const
+{
+    return m_rows.size();
+}
+
+QVector<ParsedBlocksModel::Row> ParsedBlocksModel::getRows() const
+{
+    return m_rows;
+}
+
+QVector<bool> ParsedBlocksModel::getSelection() const
+{
+    return m_selection;
+}
+
+bool ParsedBlocksModel::isSelected(int row) const
+{
+    return row >= m_selection.size() || m_selection.at(row);
+}
+
+void ParsedBlocksModel::toggleSelection(int row)
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return;
+    }
+
+    m_selection[row] = !m_selection[row];
+    const auto i { index(row) };
+    emit dataChanged(i, i, { BlockRole });
+}
+
+QVariantMap ParsedBlocksModel::get(int row) const
+{
+    if (row < 0 || row >= m_rows.size()) {
+        return { };
+    }
+    return toVariantMap(m_rows.at(row), row, isSelected(row));
+}
+
+QVariantMap ParsedBlocksModel::toVariantMap(const Row& row, int blockNumber, bool selected)
+{
+    QVariantMap m {
+        { "block", QVariantMap { {"blockSelected", selected}, {"blockNumber", blockNumber} } },
+        { "blockType", row.blockType },
+        { "blockName", row.blockName },
+        { "blockSize", row.blockSize },
+        { "blockStatus", row.blockStatus }
+    };
+    if (row.state.isValid()) {
+        m.insert("state", row.state);
+    }
+    return m;
+}
@@ -0,0 +1,90 @@
+//*******************************************************************************
+// ZX Tape Reviver
+//-----------------
+//
+// Author: Leonid Golouz
+// E-mail: lgolouz@list.ru
+// YouTube channel: https://www.youtube.com/channel/UCz_ktTqWVekT0P4zVW8Xgcg
+// YouTube channel e-mail: computerenthusiasttips@mail.ru
+//
+// Code modification and distribution of any kind is not allowed without direct
+// permission of the Author.
+//*******************************************************************************
+
+
+#ifndef PARSEDBLOCKSMODEL_H
+#define PARSEDBLOCKSMODEL_H
+
+#include <QAbstractListModel>
+#include <QSharedPointer>
+#include <QVariantMap>
+#include <QVector>
+#include "sources/core/parseddata.h"
+
+//List of the data blocks parsed from one channel.
+//Texts of the rows are built once when the blocks are set, so the views read them without formatting anything,
+//and only the row of the toggled block is updated when the selection is changed.
+class ParsedBlocksModel final : public QAbstractListModel
+{
+    Q_OBJECT
+
+    Q_PROPERTY(int count READ getCount NOTIFY countChanged)
+
+public:
+    enum Roles {
+        BlockRole = Qt::UserRole + 1,
+        BlockTypeRole,
+        BlockNameRole,
+        BlockSizeRole,
+        BlockStatusRole,
+        StateRole
+    };
+    Q_ENUM(Roles)
+
+    struct Row
+    {
+        QString blockType;
+        QString blockName;
+        QVariant blockSize;
+        QString blockStatus;
+        QVariant state;
+    };
+
+private:
+    ParsedData::SnapshotPtr m_snapshot;
+    QVector<Row> m_rows;
+    //Selection of the blocks is kept by their numbers over the parsings, new blocks are selected
+    QVector<bool> m_selection;
+
+    static Row makeRow(const ParsedData::DataBlock& block);
+    void buildRows();
+
+public:
+    explicit ParsedBlocksModel(QObject* parent = nullptr);
+    virtual ~ParsedBlocksModel() override = default;
+
+    ParsedBlocksModel(const ParsedBlocksModel& other) = delete;
+    ParsedBlocksModel(ParsedBlocksModel&& other) = delete;
+    ParsedBlocksModel& operator= (const ParsedBlocksModel& other) = delete;
+    ParsedBlocksModel& operator= (ParsedBlocksModel&& other) = delete;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    void setBlocks(const ParsedData::SnapshotPtr& snapshot);
+    int getCount() const;
+    QVector<Row> getRows() const;
+    QVector<bool> getSelection() const;
+    bool isSelected(int row) const;
+
+    Q_INVOKABLE void toggleSelection(int row);
+    //Returns the row as the map of the role values
+    Q_INVOKABLE QVariantMap get(int row) const;
+    static QVariantMap toVariantMap(const Row& row, int blockNumber, bool selected);
+
+signals:
+    void countChanged();
+};
+
+#endif // PARSEDBLOCKSMODEL_H
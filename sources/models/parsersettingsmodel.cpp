@@ -35,7 +35,14 @@ ParserSettingsModel::ParserSettingsModel(QObject* parent) :
         checkForAbnormalSine,
         sineCheckTolerance }
 {
-
+    for (auto changed: { &ParserSettingsModel::pilotHalfFreqChanged, &ParserSettingsModel::pilotFreqChanged, &ParserSettingsModel::synchroFirstHalfFreqChanged,
+                         &ParserSettingsModel::synchroSecondHalfFreqChanged, &ParserSettingsModel::synchroFreqChanged, &ParserSettingsModel::preciseSychroCheckChanged,
+                         &ParserSettingsModel::zeroHalfFreqChanged, &ParserSettingsModel::zeroFreqChanged, &ParserSettingsModel::oneHalfFreqChanged,
+                         &ParserSettingsModel::oneFreqChanged, &ParserSettingsModel::pilotDeltaChanged, &ParserSettingsModel::synchroDeltaChanged,
+                         &ParserSettingsModel::zeroDeltaChanged, &ParserSettingsModel::oneDeltaChanged, &ParserSettingsModel::checkForAbnormalSineChanged,
+                         &ParserSettingsModel::sineCheckToleranceChanged }) {
+        connect(this, changed, this, &ParserSettingsModel::parserSettingsChanged);
+    }
 }
 
 void ParserSettingsModel::restoreDefaultSettings()
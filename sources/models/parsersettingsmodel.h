@@ -58,6 +58,21 @@ public:
         double oneDelta;
         bool checkForAbnormalSine;
         double sineCheckTolerance;
+
+        bool operator==(const ParserSettings& other) const {
+            return pilotHalfFreq == other.pilotHalfFreq && pilotFreq == other.pilotFreq &&
+                   synchroFirstHalfFreq == other.synchroFirstHalfFreq && synchroSecondHalfFreq == other.synchroSecondHalfFreq &&
+                   synchroFreq == other.synchroFreq && preciseSynchroCheck == other.preciseSynchroCheck &&
+                   zeroHalfFreq == other.zeroHalfFreq && zeroFreq == other.zeroFreq &&
+                   oneHalfFreq == other.oneHalfFreq && oneFreq == other.oneFreq &&
+                   pilotDelta == other.pilotDelta && synchroDelta == other.synchroDelta &&
+                   zeroDelta == other.zeroDelta && oneDelta == other.oneDelta &&
+                   checkForAbnormalSine == other.checkForAbnormalSine && sineCheckTolerance == other.sineCheckTolerance;
+        }
+
+        bool operator!=(const ParserSettings& other) const {
+            return !(*this == other);
+        }
     };
 
     virtual ~ParserSettingsModel() = default;
@@ -120,6 +135,8 @@ signals:
     void oneDeltaChanged();
     void checkForAbnormalSineChanged();
     void sineCheckToleranceChanged();
+    //Emitted on change of any setting
+    void parserSettingsChanged();
 
 private:
     ParserSettings m_parserSettings;
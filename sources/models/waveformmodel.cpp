@@ -23,7 +23,8 @@ void WaveFormModel::initialize(QPair<QSharedPointer<QWavVector>, QSharedPointer<
 }
 
 QSharedPointer<QWavVector> WaveFormModel::getChannel(int channel) {
-    return channel < m_channels.size() ? m_channels.at(channel) : QSharedPointer<QWavVector>::create();
+    //Streamed files have no channels loaded, so the empty one is returned for them as well
+    return channel < m_channels.size() && !m_channels.at(channel).isNull() ? m_channels.at(channel) : QSharedPointer<QWavVector>::create();
 }
 
 WaveFormModel* WaveFormModel::instance() {
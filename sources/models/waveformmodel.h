@@ -14,7 +14,7 @@
 #ifndef WAVEFORMMODEL_H
 #define WAVEFORMMODEL_H
 
-#include "sources/defines.h"
+#include "sources/core/wavvector.h"
 #include <QSharedPointer>
 #include <QVector>
 
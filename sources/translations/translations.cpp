@@ -25,3 +25,5 @@ const char* ID_CODE                  = QT_TRID_NOOP("id_code");
 const char* ID_EDIT_ACTION           = QT_TRID_NOOP("id_edit_action");
 const char* ID_SHIFT_WAVEFORM_ACTION = QT_TRID_NOOP("id_shift_waveform_action");
 const char* ID_PARITY_MESSAGE        = QT_TRID_NOOP("id_parity_message");
+const char* ID_FLIP_BITS_ACTION      = QT_TRID_NOOP("id_flip_bits_action");
+const char* ID_BIT_FLIP              = QT_TRID_NOOP("id_bit_flip");
@@ -25,5 +25,7 @@ extern const char* ID_CODE;
 extern const char* ID_EDIT_ACTION;
 extern const char* ID_SHIFT_WAVEFORM_ACTION;
 extern const char* ID_PARITY_MESSAGE;
+extern const char* ID_FLIP_BITS_ACTION;
+extern const char* ID_BIT_FLIP;
 
 #endif // TRANSLATIONS_H